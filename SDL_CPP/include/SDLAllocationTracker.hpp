@@ -0,0 +1,87 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLALLOCATIONTRACKER_HPP
+#define SDLALLOCATIONTRACKER_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+
+#include "SDLError.hpp"
+
+struct AllocationStats {
+    std::uint64_t count{0};
+    std::uint64_t bytes{0};
+    std::uint64_t frees{0};
+};
+
+enum class AllocationPolicy : std::uint8_t {
+    Report,
+    Abort,
+};
+
+// Liczniki alokacji na klatkę i na scope profilera.
+// Hooki (operator new/delete + SDL_SetMemoryFunctions) są aktywne tylko z DRUGSWAR_TRACK_ALLOCATIONS,
+// bez tej flagi wszystkie statystyki zostają zerowe.
+class AllocationTracker {
+public:
+    // Ostatni slot to alokacje poza jakimkolwiek scope
+    static constexpr std::size_t max_scopes{8};
+    static constexpr std::uint8_t no_scope{max_scopes - 1};
+
+    using ScopeStats = std::array<AllocationStats, max_scopes>;
+
+    [[nodiscard]] static constexpr bool enabled() noexcept {
+#ifdef DRUGSWAR_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Musi zostać wywołane przed SDL_Init
+    static void install_sdl_hooks() noexcept;
+
+    // Zamyka poprzednią klatkę. Wywoływane z wątku pętli gry.
+    static void begin_frame(bool steady_state) noexcept;
+
+    // Tryb ścisły: po warmup_frames każda alokacja w klatce steady-state jest błędem
+    static void enable_strict_mode(std::uint64_t warmup_frames, AllocationPolicy policy) noexcept;
+    static void disable_strict_mode() noexcept;
+
+    [[nodiscard]] static AllocationStats last_frame() noexcept;
+    [[nodiscard]] static ScopeStats last_frame_scopes() noexcept;
+    [[nodiscard]] static AllocationStats total() noexcept;
+    [[nodiscard]] static std::uint64_t steady_state_violations() noexcept;
+
+    // Dla benchmarków: błąd jeśli w steady-state pojawiła się jakakolwiek alokacja
+    [[nodiscard]] static auto verify_steady_state() noexcept -> std::expected<void, SDLError>;
+
+    // Wywoływane przez hooki
+    static void record_allocation(std::size_t bytes) noexcept;
+    static void record_free() noexcept;
+
+    static std::uint8_t exchange_scope(std::uint8_t scope) noexcept;
+};
+
+// RAII przypisanie alokacji do scope profilera
+class AllocationScope {
+private:
+    std::uint8_t m_previous;
+
+public:
+    explicit AllocationScope(std::uint8_t scope) noexcept
+        : m_previous(AllocationTracker::exchange_scope(scope)) {
+    }
+
+    ~AllocationScope() noexcept {
+        AllocationTracker::exchange_scope(m_previous);
+    }
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+};
+
+#endif //SDLALLOCATIONTRACKER_HPP
@@ -5,6 +5,8 @@
 #ifndef SDLARGUMENTSSTRUCTURE
 #define SDLARGUMENTSSTRUCTURE
 #include <array>
+#include <chrono>
+#include <cstddef>
 #include <optional>
 #include <string>
 
@@ -24,6 +26,28 @@ struct RenderConfig {
     std::optional<std::string> renderer_name{std::nullopt}; // POPRAWKA: std::string
 };
 
+struct AudioConfig {
+    int frequency{48000};
+    int channels{2};
+    std::size_t max_voices{32};
+    float master_gain{1.0f};
+};
+
+struct LoggerConfig {
+    bool console{true};
+    std::optional<std::string> file_path{std::nullopt};
+    std::chrono::milliseconds flush_interval{5};
+};
+
+// Promienie w pikselach świata; unload_radius > load_radius daje histerezę
+struct StreamingConfig {
+    int region_tiles{32};
+    float load_radius{512.0f};
+    float unload_radius{768.0f};
+    std::size_t memory_cap_bytes{64u * 1024u * 1024u};
+    int max_uploads_per_frame{2};
+};
+
 struct RenderLogicalPresentation {
     int width{640};
     int height{320};
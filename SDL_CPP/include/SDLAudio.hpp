@@ -0,0 +1,480 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLAUDIO_HPP
+#define SDLAUDIO_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <SDL3/SDL.h>
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+#include "SDLArgumentsStructure.hpp"
+#include "SDLError.hpp"
+#include "SDLLogger.hpp"
+#include "SDLResourcesAliases.hpp"
+#include "SDLSpscRingBuffer.hpp"
+
+// Efekt zdekodowany z góry do formatu miksera (float32, przeplatane kanały)
+struct SfxClip {
+    std::vector<float> samples{};
+};
+
+struct AudioStats {
+    std::uint64_t underruns{0};
+    std::uint64_t voices_stolen{0};
+    std::uint64_t mixed_frames{0};
+    std::uint64_t music_frames{0};
+    std::uint32_t active_voices{0};
+    // Czas miksowania / czas trwania bloku, w promilach
+    std::uint32_t last_mix_load_permille{0};
+    std::uint32_t peak_mix_load_permille{0};
+};
+
+// Mikser niezależny od urządzenia - mix() można wołać bez SDL audio (np. ze sterownikiem dummy)
+class AudioMixer {
+public:
+    static constexpr std::size_t voice_capacity{64};
+    static constexpr std::size_t music_ring_capacity{1u << 15};
+
+    using MusicRing = SpscRingBuffer<float, music_ring_capacity>;
+
+private:
+    struct Voice {
+        const SfxClip *clip{nullptr};
+        std::size_t cursor{0};
+        float gain{1.0f};
+        std::uint64_t started{0};
+    };
+
+    struct PlayCommand {
+        const SfxClip *clip;
+        float gain;
+    };
+
+    MusicRing m_music{};
+    SpscRingBuffer<PlayCommand, 256> m_commands{};
+    std::array<Voice, voice_capacity> m_voices{};
+    std::size_t m_voice_limit;
+    std::uint64_t m_voice_counter{0};
+    double m_ns_per_sample;
+    double m_ticks_to_ns;
+    std::atomic<bool> m_music_active{false};
+    std::atomic<std::uint64_t> m_underruns{0};
+    std::atomic<std::uint64_t> m_voices_stolen{0};
+    std::atomic<std::uint64_t> m_mixed_samples{0};
+    std::atomic<std::uint64_t> m_music_samples{0};
+    std::atomic<float> m_master_gain{1.0f};
+    std::atomic<std::uint32_t> m_active_voices{0};
+    std::atomic<std::uint32_t> m_last_load{0};
+    std::atomic<std::uint32_t> m_peak_load{0};
+    int m_channels;
+
+    static void mix_add(float *dst, const float *src, std::size_t count, float gain) noexcept {
+        std::size_t i = 0;
+#if defined(__SSE__) || defined(_M_X64)
+        const __m128 g = _mm_set1_ps(gain);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] += src[i] * gain;
+        }
+    }
+
+    static void clamp_and_scale(float *dst, std::size_t count, float gain) noexcept {
+        std::size_t i = 0;
+#if defined(__SSE__) || defined(_M_X64)
+        const __m128 g = _mm_set1_ps(gain);
+        const __m128 lo = _mm_set1_ps(-1.0f);
+        const __m128 hi = _mm_set1_ps(1.0f);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(dst + i), g), lo), hi));
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] = std::clamp(dst[i] * gain, -1.0f, 1.0f);
+        }
+    }
+
+    // Limit głosów: gdy brak wolnego slotu, zastępujemy najstarszy głos
+    void start_voice(const PlayCommand &command) noexcept {
+        Voice *target = nullptr;
+        for (std::size_t i = 0; i < m_voice_limit; ++i) {
+            auto &voice = m_voices[i];
+            if (!voice.clip) {
+                target = &voice;
+                break;
+            }
+            if (!target || voice.started < target->started) {
+                target = &voice;
+            }
+        }
+        if (target->clip) {
+            m_voices_stolen.fetch_add(1, std::memory_order_relaxed);
+        }
+        *target = Voice{command.clip, 0, command.gain, m_voice_counter++};
+    }
+
+public:
+    AudioMixer(int frequency, int channels, std::size_t voice_limit) noexcept
+        : m_voice_limit(std::clamp<std::size_t>(voice_limit, 1, voice_capacity)),
+          m_ns_per_sample(1e9 / (static_cast<double>(frequency) * channels)),
+          m_ticks_to_ns(1e9 / static_cast<double>(SDL_GetPerformanceFrequency())),
+          m_channels(channels) {
+    }
+
+    // Wątek gry. false gdy kolejka poleceń jest pełna.
+    bool play(const SfxClip &clip, float gain = 1.0f) noexcept {
+        if (clip.samples.empty()) return false;
+        return m_commands.try_push(PlayCommand{&clip, gain});
+    }
+
+    // Dowolny wątek - callback audio czyta wartość raz na blok
+    void set_master_gain(float gain) noexcept {
+        m_master_gain.store(gain, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] float master_gain() const noexcept {
+        return m_master_gain.load(std::memory_order_relaxed);
+    }
+
+    // Wątek streamujący muzykę
+    [[nodiscard]] MusicRing &music() noexcept {
+        return m_music;
+    }
+
+    // Underrun liczony tylko gdy muzyka powinna grać
+    void set_music_active(bool active) noexcept {
+        m_music_active.store(active, std::memory_order_release);
+    }
+
+    // Wątek audio. Brak danych muzyki = cisza w brakującej części bloku + licznik underrun,
+    // odtwarzanie wznawia się od miejsca przerwania.
+    void mix(std::span<float> out) noexcept {
+        const Uint64 start = SDL_GetPerformanceCounter();
+
+        while (const auto command = m_commands.try_pop()) {
+            start_voice(*command);
+        }
+
+        const bool music_expected = m_music_active.load(std::memory_order_acquire);
+        const auto music_samples = m_music.read(out);
+        m_music_samples.fetch_add(music_samples, std::memory_order_relaxed);
+        if (music_samples < out.size()) {
+            std::fill(out.begin() + music_samples, out.end(), 0.0f);
+            if (music_expected) {
+                m_underruns.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        std::uint32_t active = 0;
+        for (std::size_t i = 0; i < m_voice_limit; ++i) {
+            auto &voice = m_voices[i];
+            if (!voice.clip) continue;
+            const auto &samples = voice.clip->samples;
+            const auto count = std::min(out.size(), samples.size() - voice.cursor);
+            mix_add(out.data(), samples.data() + voice.cursor, count, voice.gain);
+            voice.cursor += count;
+            if (voice.cursor >= samples.size()) {
+                voice.clip = nullptr;
+            } else {
+                ++active;
+            }
+        }
+
+        clamp_and_scale(out.data(), out.size(), m_master_gain.load(std::memory_order_relaxed));
+
+        const double mix_ns = static_cast<double>(SDL_GetPerformanceCounter() - start) * m_ticks_to_ns;
+        const auto load = static_cast<std::uint32_t>(1000.0 * mix_ns / (m_ns_per_sample * out.size()));
+        m_last_load.store(load, std::memory_order_relaxed);
+        if (load > m_peak_load.load(std::memory_order_relaxed)) {
+            m_peak_load.store(load, std::memory_order_relaxed);
+        }
+        m_active_voices.store(active, std::memory_order_relaxed);
+        m_mixed_samples.fetch_add(out.size(), std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] AudioStats stats() const noexcept {
+        return AudioStats{
+            .underruns = m_underruns.load(std::memory_order_relaxed),
+            .voices_stolen = m_voices_stolen.load(std::memory_order_relaxed),
+            .mixed_frames = m_mixed_samples.load(std::memory_order_relaxed) / static_cast<std::uint64_t>(m_channels),
+            .music_frames = m_music_samples.load(std::memory_order_relaxed) / static_cast<std::uint64_t>(m_channels),
+            .active_voices = m_active_voices.load(std::memory_order_relaxed),
+            .last_mix_load_permille = m_last_load.load(std::memory_order_relaxed),
+            .peak_mix_load_permille = m_peak_load.load(std::memory_order_relaxed),
+        };
+    }
+};
+
+// Urządzenie SDL + wątek streamujący muzykę do ringu miksera
+class AudioSystem {
+private:
+    static constexpr std::size_t block_samples{2048};
+    static constexpr std::size_t stream_chunk_samples{4096};
+
+    SDL_AudioSpec m_spec;
+    AudioMixer m_mixer;
+    SDL_AudioStreamPtr m_stream{};
+    std::vector<std::unique_ptr<SfxClip> > m_clips{};
+    std::array<float, block_samples> m_block{};
+
+    std::mutex m_music_mutex{};
+    std::string m_pending_music{};
+    bool m_pending_loop{false};
+    std::atomic<bool> m_music_request{false};
+    // Budzenie wątku streamującego: play_music(), zwolnienie miejsca w ringu, zatrzymanie
+    std::atomic<std::uint32_t> m_streamer_wake{0};
+    std::jthread m_streamer{};
+
+    static void SDLCALL audio_callback(void *userdata, SDL_AudioStream *stream,
+                                       int additional_amount, [[maybe_unused]] int total_amount) {
+        auto *self = static_cast<AudioSystem *>(userdata);
+        const auto channels = static_cast<std::size_t>(self->m_spec.channels);
+        const auto frame_bytes = channels * sizeof(float);
+        // Zaokrąglenie w górę do pełnych ramek
+        auto remaining = (static_cast<std::size_t>(additional_amount) + frame_bytes - 1) / frame_bytes * channels;
+        const auto max_block = block_samples / channels * channels;
+        while (remaining > 0) {
+            const auto count = std::min(remaining, max_block);
+            self->m_mixer.mix(std::span(self->m_block.data(), count));
+            SDL_PutAudioStreamData(stream, self->m_block.data(), static_cast<int>(count * sizeof(float)));
+            remaining -= count;
+        }
+        if (self->m_mixer.music().free_space() >= stream_chunk_samples) {
+            self->wake_streamer();
+        }
+    }
+
+    void wake_streamer() noexcept {
+        m_streamer_wake.fetch_add(1, std::memory_order_release);
+        m_streamer_wake.notify_one();
+    }
+
+    void stream_music(const std::stop_token &stop_token) {
+        struct WavData {
+            Uint8 *data{nullptr};
+            ~WavData() { SDL_free(data); }
+        };
+
+        std::unique_ptr<WavData> wav{};
+        SDL_AudioStreamPtr converter{};
+        SDL_AudioSpec source_spec{};
+        Uint32 wav_length{0};
+        Uint32 position{0};
+        bool loop{false};
+        bool draining{false};
+        std::vector<float> chunk(stream_chunk_samples);
+
+        auto stop_music = [&] {
+            m_mixer.set_music_active(false);
+            converter.reset();
+            wav.reset();
+        };
+
+        while (!stop_token.stop_requested()) {
+            // Odczyt przed sprawdzeniem warunków - budzenie w międzyczasie nie zostanie zgubione
+            const auto wake = m_streamer_wake.load(std::memory_order_acquire);
+            if (stop_token.stop_requested()) {
+                break;
+            }
+
+            if (m_music_request.exchange(false, std::memory_order_acq_rel)) {
+                std::string path;
+                {
+                    std::lock_guard lock(m_music_mutex);
+                    path = std::exchange(m_pending_music, {});
+                    loop = m_pending_loop;
+                }
+                converter.reset();
+                wav.reset();
+                m_mixer.set_music_active(false);
+
+                if (!path.empty()) {
+                    source_spec = SDL_AudioSpec{};
+                    auto loaded = std::make_unique<WavData>();
+                    if (SDL_LoadWAV(path.c_str(), &source_spec, &loaded->data, &wav_length) &&
+                        wav_length >= static_cast<Uint32>(SDL_AUDIO_FRAMESIZE(source_spec))) {
+                        converter.reset(SDL_CreateAudioStream(&source_spec, &m_spec));
+                    }
+                    if (!converter) {
+                        log_error("❌ Nie można załadować muzyki {}: {}", path, SDL_GetError());
+                        continue;
+                    }
+                    wav = std::move(loaded);
+                    position = 0;
+                    draining = false;
+                }
+            }
+
+            auto &ring = m_mixer.music();
+            if (!converter || ring.free_space() < chunk.size()) {
+                // Brak muzyki albo pełny ring - czekamy na play_music() lub callback audio
+                m_streamer_wake.wait(wake, std::memory_order_acquire);
+                continue;
+            }
+
+            // Dekodowanie porcjami - źródło trafia do konwertera tylko gdy ten jest prawie pusty.
+            // SDL odrzuca niepełne ramki (np. 24-bit stereo = 6 B), porcja jest do nich wyrównana.
+            if (!draining && SDL_GetAudioStreamAvailable(converter.get()) < static_cast<int>(chunk.size() * sizeof(float))) {
+                const auto frame_size = static_cast<Uint32>(SDL_AUDIO_FRAMESIZE(source_spec));
+                const Uint32 chunk_bytes = std::max<Uint32>(stream_chunk_samples * sizeof(float) / frame_size, 1) * frame_size;
+                const Uint32 bytes = std::min<Uint32>(wav_length - position, chunk_bytes) / frame_size * frame_size;
+                if (bytes > 0 && !SDL_PutAudioStreamData(converter.get(), wav->data + position, static_cast<int>(bytes))) {
+                    log_error("❌ SDL_PutAudioStreamData() failed: {}", SDL_GetError());
+                    stop_music();
+                    continue;
+                }
+                position += bytes;
+                // Niepełna ramka na końcu pliku jest pomijana
+                if (bytes == 0 || position >= wav_length) {
+                    if (loop) {
+                        position = 0;
+                    } else {
+                        SDL_FlushAudioStream(converter.get());
+                        draining = true;
+                    }
+                }
+            }
+
+            const int got = SDL_GetAudioStreamData(converter.get(), chunk.data(),
+                                                   static_cast<int>(chunk.size() * sizeof(float)));
+            if (got > 0) {
+                ring.write(std::span<const float>(chunk.data(), static_cast<std::size_t>(got) / sizeof(float)));
+                // Aktywna dopiero gdy w ringu są dane - start utworu nie liczy się jako underrun
+                m_mixer.set_music_active(true);
+            } else if (draining) {
+                // Koniec utworu - reszta w ringu dogra się bez liczenia underrun
+                stop_music();
+            }
+        }
+    }
+
+public:
+    explicit AudioSystem(const AudioConfig &config)
+        : m_spec{SDL_AUDIO_F32, config.channels, config.frequency},
+          m_mixer(config.frequency, config.channels, config.max_voices) {
+        m_mixer.set_master_gain(config.master_gain);
+    }
+
+    ~AudioSystem() noexcept {
+        // Najpierw wątek streamujący, potem urządzenie (callback przestaje czytać mikser)
+        m_streamer.request_stop();
+        wake_streamer();
+        if (m_streamer.joinable()) {
+            m_streamer.join();
+        }
+        m_stream.reset();
+    }
+
+    AudioSystem(const AudioSystem &) = delete;
+    AudioSystem &operator=(const AudioSystem &) = delete;
+
+    [[nodiscard]] auto open() -> std::expected<void, SDLError> {
+        m_stream.reset(SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &m_spec, audio_callback, this));
+        if (!m_stream) {
+            log_error("❌ SDL_OpenAudioDeviceStream() failed: {}", SDL_GetError());
+            return std::unexpected(SDLError::AudioInitFailed);
+        }
+        m_streamer = std::jthread([this](const std::stop_token &stop_token) { stream_music(stop_token); });
+        SDL_ResumeAudioStreamDevice(m_stream.get());
+        return {};
+    }
+
+    // Dekoduje cały efekt do formatu miksera. Wskaźnik ważny do końca życia AudioSystem.
+    [[nodiscard]] auto load_sfx(const std::string &file_path) -> std::expected<const SfxClip *, SDLError> {
+        if (!std::filesystem::exists(file_path)) {
+            log_error("File does not exist: {}", file_path);
+            return std::unexpected(SDLError::AudioLoadFailed);
+        }
+
+        SDL_AudioSpec source_spec{};
+        Uint8 *wav_data = nullptr;
+        Uint32 wav_length = 0;
+        if (!SDL_LoadWAV(file_path.c_str(), &source_spec, &wav_data, &wav_length)) {
+            log_error("❌ SDL_LoadWAV() failed: {}", SDL_GetError());
+            return std::unexpected(SDLError::AudioLoadFailed);
+        }
+
+        Uint8 *converted = nullptr;
+        int converted_length = 0;
+        const bool ok = SDL_ConvertAudioSamples(&source_spec, wav_data, static_cast<int>(wav_length),
+                                                &m_spec, &converted, &converted_length);
+        SDL_free(wav_data);
+        if (!ok) {
+            log_error("❌ SDL_ConvertAudioSamples() failed: {}", SDL_GetError());
+            return std::unexpected(SDLError::AudioLoadFailed);
+        }
+
+        auto clip = std::make_unique<SfxClip>();
+        const auto *samples = reinterpret_cast<const float *>(converted);
+        clip->samples.assign(samples, samples + converted_length / static_cast<int>(sizeof(float)));
+        SDL_free(converted);
+
+        return m_clips.emplace_back(std::move(clip)).get();
+    }
+
+    bool play_sfx(const SfxClip *clip, float gain = 1.0f) noexcept {
+        return clip && m_mixer.play(*clip, gain);
+    }
+
+    // Dekodowanie i streaming odbywa się na wątku w tle
+    void play_music(std::string file_path, bool loop = true) {
+        {
+            std::lock_guard lock(m_music_mutex);
+            m_pending_music = std::move(file_path);
+            m_pending_loop = loop;
+        }
+        m_music_request.store(true, std::memory_order_release);
+        wake_streamer();
+    }
+
+    void stop_music() {
+        play_music({}, false);
+    }
+
+    void set_master_gain(float gain) noexcept {
+        m_mixer.set_master_gain(gain);
+    }
+
+    [[nodiscard]] AudioStats stats() const noexcept {
+        return m_mixer.stats();
+    }
+};
+
+[[nodiscard]] inline auto createAudioSystem(const AudioConfig &config) noexcept
+    -> std::expected<std::unique_ptr<AudioSystem>, SDLError> {
+    try {
+        if (!SDL_WasInit(SDL_INIT_AUDIO)) [[unlikely]] {
+            return std::unexpected(SDLError::AudioInitFailed);
+        }
+        auto audio = std::make_unique<AudioSystem>(config);
+        if (auto result = audio->open(); !result) {
+            return std::unexpected(result.error());
+        }
+        log_info("✅ Audio uruchomione: {} Hz, {} kanały, {} głosów",
+                 config.frequency, config.channels, config.max_voices);
+        return audio;
+    } catch (...) {
+        return std::unexpected(SDLError::AudioInitFailed);
+    }
+}
+
+#endif //SDLAUDIO_HPP
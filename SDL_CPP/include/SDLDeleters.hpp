@@ -4,7 +4,6 @@
 
 #ifndef SDLDELETERS_HPP
 #define SDLDELETERS_HPP
-#include <iostream>
 #include <SDL3/SDL.h>
 #include "SDLResourcesConcepts.hpp"
 
@@ -20,6 +19,9 @@ struct SDL_CustomDeleter {
             if (resource) SDL_DestroySurface(resource);
         } else if constexpr (std::same_as<T, SDL_Texture>) {
             if (resource) SDL_DestroyTexture(resource);
+        } else if constexpr (std::same_as<T, SDL_AudioStream>) {
+            // Zamyka też urządzenie otwarte przez SDL_OpenAudioDeviceStream
+            if (resource) SDL_DestroyAudioStream(resource);
         }
     }
 };
@@ -6,7 +6,9 @@
 #define SDLERROR_HPP
 #include <cstdint>
 #include <format>
+#include <string>
 #include <string_view>
+#include <SDL3/SDL.h>
 
 // C++20 Strong typing z enum class
 enum class [[nodiscard]] SDLError : std::uint8_t {
@@ -16,6 +18,11 @@ enum class [[nodiscard]] SDLError : std::uint8_t {
     RenderingFailed,
     TextureCreationFailed,
     SDLStateFailed,
+    SteadyStateAllocation,
+    AudioInitFailed,
+    AudioLoadFailed,
+    NavigationBuildFailed,
+    MapStreamingFailed,
 };
 
 // C++20 constexpr
@@ -27,12 +34,17 @@ constexpr std::string_view get_error_prefix(SDLError error) noexcept {
         case SDLError::RenderingFailed: return "Rendering failed";
         case SDLError::TextureCreationFailed: return "Texture creation failed";
         case SDLError::SDLStateFailed: return "SDL state failed";
+        case SDLError::SteadyStateAllocation: return "Allocation in steady-state frame";
+        case SDLError::AudioInitFailed: return "Audio initialization failed";
+        case SDLError::AudioLoadFailed: return "Audio loading failed";
+        case SDLError::NavigationBuildFailed: return "Navigation grid build failed";
+        case SDLError::MapStreamingFailed: return "Map streaming setup failed";
     }
     return "Unknown error";
 }
 
 // POPRAWKA: Bezpieczne formatowanie
-[[nodiscard]] std::string error_to_string(SDLError error) {
+[[nodiscard]] inline std::string error_to_string(SDLError error) {
     try {
         auto prefix = get_error_prefix(error);
         auto sdl_error = SDL_GetError();
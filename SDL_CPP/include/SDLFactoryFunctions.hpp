@@ -12,6 +12,7 @@
 
 #include "SDLArgumentsStructure.hpp"
 #include "SDLError.hpp"
+#include "SDLLogger.hpp"
 #include "SdlManager.hpp"
 #include "SDLResourcesAliases.hpp"
 
@@ -41,11 +42,11 @@ initializeSDL() noexcept {
         );
 
         if (!window) [[unlikely]] {
-            std::cerr << "Window creation failed: " << SDL_GetError() << "\n";
+            log_error("Window creation failed: {}", SDL_GetError());
             return std::unexpected(SDLError::WindowCreationFailed);
         }
 
-        std::cout << std::format("✅ Okno utworzone: {}x{}\n", config.width, config.height);
+        log_info("✅ Okno utworzone: {}x{}", config.width, config.height);
         return SDL_WindowPtr{window};
     } catch (...) {
         return std::unexpected(SDLError::WindowCreationFailed);
@@ -61,11 +62,11 @@ initializeSDL() noexcept {
 
         auto *renderer = SDL_CreateRenderer(window, name);
         if (!renderer) [[unlikely]] {
-            std::cerr << "Renderer creation failed: " << SDL_GetError() << "\n";
+            log_error("Renderer creation failed: {}", SDL_GetError());
             return std::unexpected(SDLError::RendererCreationFailed);
         }
 
-        std::cout << "✅ Renderer utworzony\n";
+        log_info("✅ Renderer utworzony");
         return SDL_RendererPtr{renderer};
     } catch (...) {
         return std::unexpected(SDLError::RendererCreationFailed);
@@ -76,17 +77,17 @@ initializeSDL() noexcept {
                                  const std::string &file_path) noexcept -> std::expected<SDL_TexturePtr, SDLError> {
     try {
         if (!std::filesystem::exists(file_path)) {
-            std::cerr << "File does not exist: " << file_path << "\n";
+            log_error("File does not exist: {}", file_path);
             return std::unexpected(SDLError::TextureCreationFailed);
         }
 
         auto *texture = IMG_LoadTexture(renderer, file_path.c_str());
         if (!texture) [[unlikely]] {
-            std::cerr << "Texture creation failed: " << SDL_GetError() << "\n";
+            log_error("Texture creation failed: {}", SDL_GetError());
             return std::unexpected(SDLError::TextureCreationFailed);
         }
 
-        std::cout << "✅ Tekstura utworzona\n";
+        log_info("✅ Tekstura utworzona");
         return SDL_TexturePtr{texture};
     } catch (...) {
         return std::unexpected(SDLError::TextureCreationFailed);
@@ -5,10 +5,14 @@
 #ifndef SDLGAMEENGINESTRUCTURES_HPP
 #define SDLGAMEENGINESTRUCTURES_HPP
 
+#include <array>
+#include <cstdint>
+
 #include "SDLResourcesAliases.hpp"
 
 const std::string project_root = std::filesystem::current_path().parent_path().string();
 const std::string idle_texture_path = project_root + "/Data/idle.png";
+const std::string world_map_path = project_root + "/Data/world.tmj";
 
 
 struct SDLState {
@@ -17,4 +21,45 @@ struct SDLState {
     int width, height, logW, logH;
 };
 
+// Stan symulacji w układzie SoA - trivially copyable, żeby migawki były zwykłym memcpy.
+// Encja 0 to gracz.
+struct alignas(std::uint64_t) SimulationWorld {
+    static constexpr std::size_t max_entities{256};
+
+    std::uint64_t frame{0};
+    std::uint32_t entity_count{0};
+    std::array<float, max_entities> position_x{};
+    std::array<float, max_entities> position_y{};
+    std::array<float, max_entities> velocity_x{};
+    std::array<std::uint8_t, max_entities> flip_horizontal{};
+
+    bool operator==(const SimulationWorld &) const noexcept = default;
+};
+
+// Wejście, które wyprodukowało daną klatkę - potrzebne do ponownej symulacji
+struct FrameInput {
+    float delta_time{0};
+    bool left{false};
+    bool right{false};
+};
+
+// Rollback sięga 8 klatek wstecz - ring migawek trzyma też klatkę bieżącą
+inline constexpr std::size_t rollback_frames{8};
+inline constexpr std::size_t snapshot_depth{rollback_frames + 1};
+
+// Deterministyczny krok symulacji - ta sama funkcja dla gry i ponownej symulacji
+inline void step_world(SimulationWorld &world, const FrameInput &input) noexcept {
+    if (input.left) {
+        world.velocity_x[0] += -5.0f;
+        world.flip_horizontal[0] = true;
+    } else if (input.right) {
+        world.velocity_x[0] += 5.0f;
+        world.flip_horizontal[0] = false;
+    } else {
+        world.velocity_x[0] = 0.0f;
+    }
+    world.position_x[0] += world.velocity_x[0] * input.delta_time;
+    ++world.frame;
+}
+
 #endif //SDL_GAMEENGINESTRUCTURES_HPP
@@ -0,0 +1,232 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLLOGGER_HPP
+#define SDLLOGGER_HPP
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "SDLArgumentsStructure.hpp"
+
+enum class LogLevel : std::uint8_t {
+    Trace = 0,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Critical,
+    Off,
+};
+
+// Filtrowanie w czasie kompilacji: -DDRUGSWAR_LOG_MIN_LEVEL=<0..6>, niższe poziomy znikają z kodu
+#ifndef DRUGSWAR_LOG_MIN_LEVEL
+#define DRUGSWAR_LOG_MIN_LEVEL 1
+#endif
+
+inline constexpr LogLevel compile_time_log_level{static_cast<LogLevel>(DRUGSWAR_LOG_MIN_LEVEL)};
+
+constexpr std::string_view get_log_level_name(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO ";
+        case LogLevel::Warn: return "WARN ";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Critical: return "CRIT ";
+        case LogLevel::Off: break;
+    }
+    return "?????";
+}
+
+namespace logging {
+    inline constexpr std::size_t inline_string_capacity{119};
+    inline constexpr std::size_t record_args_capacity{256};
+    inline constexpr std::string_view truncation_marker{"\u2026"};
+
+    // Kopia napisu w rekordzie - źródło (np. SDL_GetError()) może się zmienić przed formatowaniem
+    struct InlineString {
+        std::uint8_t size{0};
+        std::array<char, inline_string_capacity> data{};
+
+        [[nodiscard]] std::string_view view() const noexcept {
+            return {data.data(), size};
+        }
+    };
+
+    template<typename T>
+    [[nodiscard]] auto capture(const T &value) noexcept {
+        using Decayed = std::decay_t<T>;
+        if constexpr (std::is_same_v<Decayed, const char *> || std::is_same_v<Decayed, char *>) {
+            return capture(std::string_view{value ? value : "(null)"});
+        } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+            const std::string_view text{value};
+            InlineString result{};
+            if (text.size() <= inline_string_capacity) {
+                result.size = static_cast<std::uint8_t>(text.size());
+                std::copy_n(text.data(), result.size, result.data.data());
+                return result;
+            }
+            // Ucięty napis kończy się "…", cięcie nie wypada w środku znaku UTF-8
+            std::size_t length = inline_string_capacity - truncation_marker.size();
+            while (length > 0 && (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) {
+                --length;
+            }
+            std::copy_n(text.data(), length, result.data.data());
+            std::copy_n(truncation_marker.data(), truncation_marker.size(), result.data.data() + length);
+            result.size = static_cast<std::uint8_t>(length + truncation_marker.size());
+            return result;
+        } else {
+            static_assert(std::is_trivially_copyable_v<Decayed>,
+                          "Argumenty logów muszą być trivially copyable albo napisami");
+            return Decayed{value};
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]] auto unwrap(const T &value) noexcept {
+        if constexpr (std::is_same_v<T, InlineString>) {
+            return value.view();
+        } else {
+            return value;
+        }
+    }
+
+    // Rozmieszczenie przechwyconych argumentów w buforze rekordu
+    template<typename... Ts>
+    struct ArgsLayout {
+        static constexpr auto offsets = [] {
+            std::array<std::size_t, sizeof...(Ts)> result{};
+            std::size_t offset = 0;
+            std::size_t i = 0;
+            ((offset = (offset + alignof(Ts) - 1) / alignof(Ts) * alignof(Ts), result[i++] = offset, offset += sizeof(Ts)), ...);
+            return result;
+        }();
+
+        static constexpr std::size_t size = [] {
+            std::size_t offset = 0;
+            ((offset = (offset + alignof(Ts) - 1) / alignof(Ts) * alignof(Ts) + sizeof(Ts)), ...);
+            return offset;
+        }();
+    };
+
+    struct LogRecord {
+        using FormatFn = void (*)(std::string &out, std::string_view fmt, const std::byte *args);
+
+        FormatFn format_fn{nullptr};
+        std::string_view fmt{};
+        std::uint64_t timestamp_ns{0};
+        std::uint32_t thread_id{0};
+        LogLevel level{LogLevel::Info};
+        alignas(std::max_align_t) std::array<std::byte, record_args_capacity> args{};
+    };
+
+    // Wykonywane dopiero na wątku loggera
+    template<typename... Ts>
+    void format_record(std::string &out, std::string_view fmt, const std::byte *args) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            std::tuple<Ts...> values{};
+            (std::memcpy(&std::get<I>(values), args + ArgsLayout<Ts...>::offsets[I], sizeof(Ts)), ...);
+            auto unwrapped = std::tuple{unwrap(std::get<I>(values))...};
+            std::apply([&](auto &... value) {
+                std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(value...));
+            }, unwrapped);
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    template<typename... Ts>
+    void store_args(LogRecord &record, const Ts &... values) noexcept {
+        static_assert(ArgsLayout<Ts...>::size <= record_args_capacity, "Za dużo argumentów w jednym logu");
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (std::memcpy(record.args.data() + ArgsLayout<Ts...>::offsets[I], &values, sizeof(Ts)), ...);
+        }(std::index_sequence_for<Ts...>{});
+        record.format_fn = &format_record<Ts...>;
+    }
+} // namespace logging
+
+// Asynchroniczny logger: każdy wątek pisze do własnego lock-free ringu, wątek w tle formatuje
+// i zapisuje na konsolę/do pliku. Pełny ring = rekord odrzucony, gorąca ścieżka nigdy nie czeka.
+class Logger {
+public:
+    static void start(const LoggerConfig &config);
+    // Opróżnia wszystkie ringi i zatrzymuje wątek
+    static void stop() noexcept;
+
+    // false gdy ring wątku jest pełny (rekord odrzucony)
+    static bool push(const logging::LogRecord &record) noexcept;
+
+    [[nodiscard]] static std::uint64_t dropped() noexcept;
+
+    template<typename... Args>
+    static void log(LogLevel level, std::format_string<Args...> fmt, const Args &... args) noexcept {
+        if (level < compile_time_log_level || level == LogLevel::Off) {
+            return;
+        }
+        logging::LogRecord record{};
+        record.fmt = fmt.get();
+        record.level = level;
+        record.timestamp_ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        logging::store_args(record, logging::capture(args)...);
+        push(record);
+    }
+};
+
+// RAII: start na początku main, stop (z opróżnieniem kolejek) na końcu
+class LoggerGuard {
+public:
+    explicit LoggerGuard(const LoggerConfig &config) {
+        Logger::start(config);
+    }
+
+    ~LoggerGuard() noexcept {
+        Logger::stop();
+    }
+
+    LoggerGuard(const LoggerGuard &) = delete;
+    LoggerGuard &operator=(const LoggerGuard &) = delete;
+};
+
+template<typename... Args>
+void log_trace(std::format_string<Args...> fmt, const Args &... args) noexcept {
+    if constexpr (LogLevel::Trace >= compile_time_log_level) Logger::log(LogLevel::Trace, fmt, args...);
+}
+
+template<typename... Args>
+void log_debug(std::format_string<Args...> fmt, const Args &... args) noexcept {
+    if constexpr (LogLevel::Debug >= compile_time_log_level) Logger::log(LogLevel::Debug, fmt, args...);
+}
+
+template<typename... Args>
+void log_info(std::format_string<Args...> fmt, const Args &... args) noexcept {
+    if constexpr (LogLevel::Info >= compile_time_log_level) Logger::log(LogLevel::Info, fmt, args...);
+}
+
+template<typename... Args>
+void log_warn(std::format_string<Args...> fmt, const Args &... args) noexcept {
+    if constexpr (LogLevel::Warn >= compile_time_log_level) Logger::log(LogLevel::Warn, fmt, args...);
+}
+
+template<typename... Args>
+void log_error(std::format_string<Args...> fmt, const Args &... args) noexcept {
+    if constexpr (LogLevel::Error >= compile_time_log_level) Logger::log(LogLevel::Error, fmt, args...);
+}
+
+template<typename... Args>
+void log_critical(std::format_string<Args...> fmt, const Args &... args) noexcept {
+    if constexpr (LogLevel::Critical >= compile_time_log_level) Logger::log(LogLevel::Critical, fmt, args...);
+}
+
+#endif //SDLLOGGER_HPP
@@ -0,0 +1,665 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLPATHFINDING_HPP
+#define SDLPATHFINDING_HPP
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <SDL3/SDL.h>
+#include <tileson.h>
+
+#include "SDLError.hpp"
+#include "SDLLogger.hpp"
+
+struct GridCell {
+    int x{0};
+    int y{0};
+
+    constexpr bool operator==(const GridCell &) const noexcept = default;
+};
+
+namespace navigation {
+    // Koszty ruchu w stylu "octile": prosto 10, po skosie 14
+    inline constexpr std::uint32_t straight_cost{10};
+    inline constexpr std::uint32_t diagonal_cost{14};
+    inline constexpr std::uint32_t unreachable{std::numeric_limits<std::uint32_t>::max()};
+    inline constexpr std::uint8_t no_direction{8};
+
+    struct Offset {
+        int dx;
+        int dy;
+        std::uint32_t cost;
+    };
+
+    inline constexpr std::array<Offset, 8> neighbours{{
+        {1, 0, straight_cost}, {-1, 0, straight_cost}, {0, 1, straight_cost}, {0, -1, straight_cost},
+        {1, 1, diagonal_cost}, {1, -1, diagonal_cost}, {-1, 1, diagonal_cost}, {-1, -1, diagonal_cost},
+    }};
+
+    // Kierunek przeciwny dla indeksów z neighbours
+    inline constexpr std::array<std::uint8_t, 9> opposite{1, 0, 3, 2, 7, 6, 5, 4, no_direction};
+
+    // Znormalizowane kierunki dla indeksów z neighbours, ostatni = brak ruchu
+    inline constexpr float diagonal{0.70710678f};
+    inline constexpr std::array<SDL_FPoint, 9> directions{{
+        {1, 0}, {-1, 0}, {0, 1}, {0, -1},
+        {diagonal, diagonal}, {diagonal, -diagonal}, {-diagonal, diagonal}, {-diagonal, -diagonal},
+        {0, 0},
+    }};
+
+    // Maska flag obrotu w GID Tiled
+    inline constexpr std::uint32_t gid_mask{0x1FFFFFFF};
+} // namespace navigation
+
+// Siatka przechodniości zbudowana z kolizji kafelków
+class NavigationGrid {
+private:
+    int m_width;
+    int m_height;
+    float m_cell_width;
+    float m_cell_height;
+    std::vector<std::uint8_t> m_blocked;
+
+public:
+    NavigationGrid(int width, int height, float cell_width, float cell_height)
+        : m_width(width), m_height(height), m_cell_width(cell_width), m_cell_height(cell_height),
+          m_blocked(static_cast<std::size_t>(width) * height, 0) {
+    }
+
+    [[nodiscard]] constexpr int width() const noexcept { return m_width; }
+    [[nodiscard]] constexpr int height() const noexcept { return m_height; }
+    [[nodiscard]] constexpr float cell_width() const noexcept { return m_cell_width; }
+    [[nodiscard]] constexpr float cell_height() const noexcept { return m_cell_height; }
+
+    [[nodiscard]] constexpr std::size_t cell_count() const noexcept {
+        return static_cast<std::size_t>(m_width) * m_height;
+    }
+
+    [[nodiscard]] constexpr bool in_bounds(GridCell cell) const noexcept {
+        return cell.x >= 0 && cell.y >= 0 && cell.x < m_width && cell.y < m_height;
+    }
+
+    [[nodiscard]] constexpr std::uint32_t index(GridCell cell) const noexcept {
+        return static_cast<std::uint32_t>(cell.y * m_width + cell.x);
+    }
+
+    [[nodiscard]] constexpr GridCell cell(std::uint32_t index) const noexcept {
+        return {static_cast<int>(index % m_width), static_cast<int>(index / m_width)};
+    }
+
+    // Poza mapą = zablokowane
+    [[nodiscard]] bool is_blocked(GridCell cell) const noexcept {
+        return !in_bounds(cell) || m_blocked[index(cell)] != 0;
+    }
+
+    void set_blocked(GridCell cell, bool blocked) noexcept {
+        if (in_bounds(cell)) m_blocked[index(cell)] = blocked ? 1 : 0;
+    }
+
+    // Ruch po skosie tylko gdy obie sąsiednie krawędzie są wolne (bez ścinania rogów)
+    [[nodiscard]] bool can_step(GridCell from, const navigation::Offset &offset) const noexcept {
+        const GridCell to{from.x + offset.dx, from.y + offset.dy};
+        if (is_blocked(to)) return false;
+        if (offset.dx != 0 && offset.dy != 0) {
+            return !is_blocked({from.x + offset.dx, from.y}) && !is_blocked({from.x, from.y + offset.dy});
+        }
+        return true;
+    }
+
+    // floor, nie obcięcie - x = -5 to komórka -1 (poza mapą), a nie 0
+    [[nodiscard]] GridCell world_to_cell(float x, float y) const noexcept {
+        return {static_cast<int>(std::floor(x / m_cell_width)), static_cast<int>(std::floor(y / m_cell_height))};
+    }
+
+    // Indeksy komórek, których przechodniość różni się od other. false gdy wymiary są różne.
+    bool changed_cells(const NavigationGrid &other, std::vector<std::uint32_t> &out) const {
+        out.clear();
+        if (m_width != other.m_width || m_height != other.m_height) {
+            return false;
+        }
+        for (std::uint32_t i = 0; i < m_blocked.size(); ++i) {
+            if (m_blocked[i] != other.m_blocked[i]) out.push_back(i);
+        }
+        return true;
+    }
+
+    [[nodiscard]] SDL_FPoint cell_center(GridCell cell) const noexcept {
+        return {(static_cast<float>(cell.x) + 0.5f) * m_cell_width, (static_cast<float>(cell.y) + 0.5f) * m_cell_height};
+    }
+};
+
+namespace navigation {
+    [[nodiscard]] inline bool has_collision(tson::Property *property) {
+        return property != nullptr && property->getValue<bool>();
+    }
+
+    // Warstwa z "collision" = true blokuje każdy niepusty kafelek, inaczej decyduje właściwość kafelka
+    inline void mark_collisions(NavigationGrid &grid, tson::Map &map, std::vector<tson::Layer> &layers) {
+        for (auto &layer: layers) {
+            if (layer.getType() == tson::LayerType::Group) {
+                mark_collisions(grid, map, layer.getLayers());
+                continue;
+            }
+            if (layer.getType() != tson::LayerType::TileLayer) {
+                continue;
+            }
+
+            const bool layer_collides = has_collision(layer.getProp("collision"));
+            auto &tiles = map.getTileMap();
+            const auto &data = layer.getData();
+            const auto count = std::min(data.size(), grid.cell_count());
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::uint32_t gid = data[i] & gid_mask;
+                if (gid == 0) continue;
+
+                bool blocked = layer_collides;
+                if (!blocked) {
+                    const auto tile = tiles.find(gid);
+                    blocked = tile != tiles.end() && tile->second && has_collision(tile->second->getProp("collision"));
+                }
+                if (blocked) {
+                    grid.set_blocked(grid.cell(static_cast<std::uint32_t>(i)), true);
+                }
+            }
+        }
+    }
+} // namespace navigation
+
+[[nodiscard]] inline auto createNavigationGrid(tson::Map &map) noexcept -> std::expected<NavigationGrid, SDLError> {
+    try {
+        if (map.getStatus() != tson::ParseStatus::OK) [[unlikely]] {
+            log_error("Map parsing failed: {}", map.getStatusMessage());
+            return std::unexpected(SDLError::NavigationBuildFailed);
+        }
+
+        const auto &size = map.getSize();
+        const auto &tile_size = map.getTileSize();
+        if (size.x <= 0 || size.y <= 0 || tile_size.x <= 0 || tile_size.y <= 0) [[unlikely]] {
+            return std::unexpected(SDLError::NavigationBuildFailed);
+        }
+
+        NavigationGrid grid(size.x, size.y, static_cast<float>(tile_size.x), static_cast<float>(tile_size.y));
+        navigation::mark_collisions(grid, map, map.getLayers());
+        return grid;
+    } catch (...) {
+        return std::unexpected(SDLError::NavigationBuildFailed);
+    }
+}
+
+// Pole przepływu do jednego celu: koszt integracji + kierunek na komórkę.
+// Próbkowanie kierunku to jedno odczytanie tablicy - O(1) na agenta.
+class FlowField {
+private:
+    using QueueEntry = std::pair<std::uint32_t, std::uint32_t>; // koszt, indeks
+    using OpenQueue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<> >;
+
+    int m_width;
+    float m_cell_width;
+    float m_cell_height;
+    GridCell m_goal;
+    std::uint64_t m_grid_version;
+    std::vector<std::uint32_t> m_integration;
+    std::vector<std::uint8_t> m_directions;
+    // Kierunek do poprzednika w drzewie najkrótszych ścieżek - wyznacza, co unieważnia zmiana siatki
+    std::vector<std::uint8_t> m_parents;
+
+    // Dijkstra od komórek w kolejce. changed dostaje komórki, którym spadł koszt.
+    void propagate(const NavigationGrid &grid, OpenQueue &open, std::vector<std::uint32_t> *changed) {
+        while (!open.empty()) {
+            const auto [cost, current] = open.top();
+            open.pop();
+            if (cost > m_integration[current]) continue;
+
+            const GridCell from = grid.cell(current);
+            for (std::uint8_t direction = 0; direction < navigation::neighbours.size(); ++direction) {
+                const auto &offset = navigation::neighbours[direction];
+                if (!grid.can_step(from, offset)) continue;
+                const auto next = grid.index({from.x + offset.dx, from.y + offset.dy});
+                const auto next_cost = cost + offset.cost;
+                if (next_cost < m_integration[next]) {
+                    m_integration[next] = next_cost;
+                    m_parents[next] = navigation::opposite[direction];
+                    open.emplace(next_cost, next);
+                    if (changed) changed->push_back(next);
+                }
+            }
+        }
+    }
+
+    // Kierunek do sąsiada o najniższym koszcie
+    void update_direction(const NavigationGrid &grid, std::uint32_t i) noexcept {
+        m_directions[i] = navigation::no_direction;
+        if (m_integration[i] == navigation::unreachable || m_integration[i] == 0) return;
+
+        const GridCell from = grid.cell(i);
+        std::uint32_t best = m_integration[i];
+        for (std::uint8_t direction = 0; direction < navigation::neighbours.size(); ++direction) {
+            const auto &offset = navigation::neighbours[direction];
+            if (!grid.can_step(from, offset)) continue;
+            const auto cost = m_integration[grid.index({from.x + offset.dx, from.y + offset.dy})];
+            if (cost < best) {
+                best = cost;
+                m_directions[i] = direction;
+            }
+        }
+    }
+
+    void build(const NavigationGrid &grid) {
+        m_integration.assign(grid.cell_count(), navigation::unreachable);
+        m_directions.assign(grid.cell_count(), navigation::no_direction);
+        m_parents.assign(grid.cell_count(), navigation::no_direction);
+        if (grid.is_blocked(m_goal)) {
+            return;
+        }
+
+        OpenQueue open{};
+        m_integration[grid.index(m_goal)] = 0;
+        open.emplace(0, grid.index(m_goal));
+        propagate(grid, open, nullptr);
+
+        for (std::uint32_t i = 0; i < m_integration.size(); ++i) {
+            update_direction(grid, i);
+        }
+    }
+
+    // Naprawa po zmianie komórek: unieważnia poddrzewa, których ścieżka przechodziła przez zmianę,
+    // liczy je od brzegu z ważnymi kosztami i odświeża kierunki tylko wokół zmienionych komórek.
+    void repair(const NavigationGrid &grid, std::span<const std::uint32_t> changed_cells) {
+        const auto goal_index = grid.index(m_goal);
+        std::vector<std::uint8_t> marked(m_integration.size(), 0);
+        std::vector<std::uint32_t> invalid{};
+
+        auto invalidate = [&](std::uint32_t i) {
+            if (marked[i] || i == goal_index || m_integration[i] == navigation::unreachable) return;
+            marked[i] = 1;
+            invalid.push_back(i);
+        };
+
+        // Zablokowane komórki i sąsiedzi, których krok do poprzednika przestał być możliwy (skosy)
+        for (const auto changed: changed_cells) {
+            invalidate(changed);
+            const GridCell cell = grid.cell(changed);
+            for (const auto &offset: navigation::neighbours) {
+                const GridCell neighbour{cell.x + offset.dx, cell.y + offset.dy};
+                if (!grid.in_bounds(neighbour)) continue;
+                const auto n = grid.index(neighbour);
+                const auto parent = m_parents[n];
+                if (parent != navigation::no_direction && !grid.can_step(neighbour, navigation::neighbours[parent])) {
+                    invalidate(n);
+                }
+            }
+        }
+
+        // Całe poddrzewa unieważnionych komórek
+        for (std::size_t k = 0; k < invalid.size(); ++k) {
+            const GridCell cell = grid.cell(invalid[k]);
+            for (std::uint8_t direction = 0; direction < navigation::neighbours.size(); ++direction) {
+                const auto &offset = navigation::neighbours[direction];
+                const GridCell neighbour{cell.x + offset.dx, cell.y + offset.dy};
+                if (!grid.in_bounds(neighbour)) continue;
+                const auto n = grid.index(neighbour);
+                if (m_parents[n] == navigation::opposite[direction]) invalidate(n);
+            }
+        }
+
+        for (const auto i: invalid) {
+            m_integration[i] = navigation::unreachable;
+            m_parents[i] = navigation::no_direction;
+        }
+
+        // Koszty brzegowe z sąsiadów; sąsiedzi zmian też, bo odblokowanie otwiera nowe przejścia
+        OpenQueue open{};
+        std::vector<std::uint32_t> touched(invalid);
+        auto seed = [&](std::uint32_t i) {
+            const GridCell cell = grid.cell(i);
+            if (grid.is_blocked(cell)) return;
+            for (std::uint8_t direction = 0; direction < navigation::neighbours.size(); ++direction) {
+                const auto &offset = navigation::neighbours[direction];
+                if (!grid.can_step(cell, offset)) continue;
+                const auto n = grid.index({cell.x + offset.dx, cell.y + offset.dy});
+                if (m_integration[n] == navigation::unreachable) continue;
+                const auto cost = m_integration[n] + offset.cost;
+                if (cost < m_integration[i]) {
+                    m_integration[i] = cost;
+                    m_parents[i] = direction;
+                    touched.push_back(i);
+                }
+            }
+            if (m_integration[i] != navigation::unreachable) {
+                open.emplace(m_integration[i], i);
+            }
+        };
+        for (const auto i: invalid) {
+            seed(i);
+        }
+        for (const auto changed: changed_cells) {
+            seed(changed);
+            const GridCell cell = grid.cell(changed);
+            for (const auto &offset: navigation::neighbours) {
+                const GridCell neighbour{cell.x + offset.dx, cell.y + offset.dy};
+                if (grid.in_bounds(neighbour)) seed(grid.index(neighbour));
+            }
+        }
+        propagate(grid, open, &touched);
+
+        // Kierunek zależy od kosztów sąsiadów - odświeżamy zmienione komórki i ich otoczenie
+        std::ranges::fill(marked, 0);
+        auto refresh = [&](GridCell cell) {
+            if (!grid.in_bounds(cell)) return;
+            const auto i = grid.index(cell);
+            if (marked[i]) return;
+            marked[i] = 1;
+            update_direction(grid, i);
+        };
+        auto refresh_around = [&](std::uint32_t i) {
+            const GridCell cell = grid.cell(i);
+            refresh(cell);
+            for (const auto &offset: navigation::neighbours) {
+                refresh({cell.x + offset.dx, cell.y + offset.dy});
+            }
+        };
+        for (const auto i: touched) {
+            refresh_around(i);
+        }
+        for (const auto changed: changed_cells) {
+            refresh_around(changed);
+        }
+    }
+
+public:
+    FlowField(const NavigationGrid &grid, GridCell goal, std::uint64_t grid_version)
+        : m_width(grid.width()), m_cell_width(grid.cell_width()), m_cell_height(grid.cell_height()),
+          m_goal(goal), m_grid_version(grid_version) {
+        build(grid);
+    }
+
+    // Przyrostowo: pole z poprzedniej wersji siatki + lista komórek, które zmieniły przechodniość
+    FlowField(const FlowField &previous, const NavigationGrid &grid,
+              std::span<const std::uint32_t> changed_cells, std::uint64_t grid_version)
+        : m_width(grid.width()), m_cell_width(grid.cell_width()), m_cell_height(grid.cell_height()),
+          m_goal(previous.m_goal), m_grid_version(grid_version),
+          m_integration(previous.m_integration), m_directions(previous.m_directions),
+          m_parents(previous.m_parents) {
+        // Inny rozmiar, zablokowany cel albo cel wcześniej zablokowany - nie ma czego naprawiać
+        if (m_integration.size() != grid.cell_count() || previous.m_width != grid.width() ||
+            grid.is_blocked(m_goal) || m_integration[grid.index(m_goal)] != 0) {
+            build(grid);
+            return;
+        }
+        repair(grid, changed_cells);
+    }
+
+    [[nodiscard]] constexpr GridCell goal() const noexcept { return m_goal; }
+    [[nodiscard]] constexpr std::uint64_t grid_version() const noexcept { return m_grid_version; }
+
+    [[nodiscard]] bool reachable(GridCell cell) const noexcept {
+        return integration_at(cell) != navigation::unreachable;
+    }
+
+    // Koszt dojścia do celu, navigation::unreachable poza mapą albo bez ścieżki
+    [[nodiscard]] std::uint32_t integration_at(GridCell cell) const noexcept {
+        const auto i = static_cast<std::size_t>(cell.y) * m_width + cell.x;
+        if (cell.x < 0 || cell.y < 0 || cell.x >= m_width || i >= m_integration.size()) {
+            return navigation::unreachable;
+        }
+        return m_integration[i];
+    }
+
+    // Kierunek w komórce, {0, 0} gdy cel osiągnięty albo nieosiągalny
+    [[nodiscard]] SDL_FPoint direction_at(GridCell cell) const noexcept {
+        const auto i = static_cast<std::size_t>(cell.y) * m_width + cell.x;
+        if (cell.x < 0 || cell.y < 0 || cell.x >= m_width || i >= m_directions.size()) {
+            return navigation::directions[navigation::no_direction];
+        }
+        return navigation::directions[m_directions[i]];
+    }
+
+    // floor, nie obcięcie - pozycje na lewo/nad mapą wypadają poza siatkę
+    [[nodiscard]] SDL_FPoint sample(float world_x, float world_y) const noexcept {
+        return direction_at({
+            static_cast<int>(std::floor(world_x / m_cell_width)),
+            static_cast<int>(std::floor(world_y / m_cell_height))
+        });
+    }
+};
+
+// Pola przepływu liczone na wątku roboczym i cache'owane per cel.
+// Zmiana siatki podbija wersję - agenci używają starego pola, dopóki nowe nie jest gotowe.
+// Pole z cache jest naprawiane przyrostowo listą zmienionych komórek, o ile historia zmian
+// sięga jego wersji; inaczej liczone od zera.
+class FlowFieldPlanner {
+private:
+    struct CacheEntry {
+        std::shared_ptr<const FlowField> field{};
+        std::uint64_t requested_version{0};
+    };
+
+    struct GridChange {
+        std::uint64_t version{0};
+        std::vector<std::uint32_t> cells{};
+    };
+
+    static constexpr std::size_t max_change_history{16};
+
+    mutable std::mutex m_mutex{};
+    std::condition_variable_any m_condition{};
+    std::shared_ptr<const NavigationGrid> m_grid;
+    std::uint64_t m_version{1};
+    std::unordered_map<std::uint32_t, CacheEntry> m_cache{};
+    std::deque<std::uint32_t> m_queue{};
+    std::deque<GridChange> m_changes{};
+    std::jthread m_worker{};
+
+    void work(const std::stop_token &stop_token) {
+        std::vector<std::uint32_t> changed{};
+        while (true) {
+            std::unique_lock lock(m_mutex);
+            if (!m_condition.wait(lock, stop_token, [this] { return !m_queue.empty(); })) {
+                return;
+            }
+            const auto goal_index = m_queue.front();
+            m_queue.pop_front();
+            const auto grid = m_grid;
+            const auto version = m_version;
+
+            std::shared_ptr<const FlowField> previous{};
+            changed.clear();
+            if (const auto it = m_cache.find(goal_index); it != m_cache.end() && it->second.field) {
+                const auto from = it->second.field->grid_version();
+                if (from >= version) {
+                    continue;
+                }
+                if (!m_changes.empty() && m_changes.front().version <= from + 1) {
+                    previous = it->second.field;
+                    for (const auto &change: m_changes) {
+                        if (change.version > from && change.version <= version) {
+                            changed.insert(changed.end(), change.cells.begin(), change.cells.end());
+                        }
+                    }
+                }
+            }
+            lock.unlock();
+
+            auto field = previous
+                             ? std::make_shared<const FlowField>(*previous, *grid, changed, version)
+                             : std::make_shared<const FlowField>(*grid, grid->cell(goal_index), version);
+
+            lock.lock();
+            // forget() mógł usunąć cel w trakcie liczenia - nie odtwarzamy wpisu
+            const auto it = m_cache.find(goal_index);
+            if (it == m_cache.end()) {
+                continue;
+            }
+            if (!it->second.field || it->second.field->grid_version() < version) {
+                it->second.field = std::move(field);
+            }
+        }
+    }
+
+public:
+    explicit FlowFieldPlanner(NavigationGrid grid)
+        : m_grid(std::make_shared<const NavigationGrid>(std::move(grid))) {
+        m_worker = std::jthread([this](const std::stop_token &stop_token) { work(stop_token); });
+    }
+
+    FlowFieldPlanner(const FlowFieldPlanner &) = delete;
+    FlowFieldPlanner &operator=(const FlowFieldPlanner &) = delete;
+
+    // Zwraca aktualne (może być nieaktualne albo puste) pole i w razie potrzeby zleca przeliczenie.
+    // Wywoływane raz na cel na klatkę - agenci próbkują zwrócone pole bez blokad.
+    [[nodiscard]] std::shared_ptr<const FlowField> request(GridCell goal) {
+        std::lock_guard lock(m_mutex);
+        if (!m_grid->in_bounds(goal)) {
+            return nullptr;
+        }
+        const auto goal_index = m_grid->index(goal);
+        auto &entry = m_cache[goal_index];
+        if (entry.requested_version < m_version) {
+            entry.requested_version = m_version;
+            m_queue.push_back(goal_index);
+            m_condition.notify_one();
+        }
+        return entry.field;
+    }
+
+    // Nowa siatka (np. otwarte drzwi). Pola w cache są naprawiane przy następnym request().
+    void update_grid(NavigationGrid grid) {
+        auto next = std::make_shared<const NavigationGrid>(std::move(grid));
+        std::shared_ptr<const NavigationGrid> current{};
+        {
+            std::lock_guard lock(m_mutex);
+            current = m_grid;
+        }
+        // Siatki są niezmienne - porównanie poza blokadą
+        std::vector<std::uint32_t> changed{};
+        const bool comparable = current->changed_cells(*next, changed);
+
+        std::lock_guard lock(m_mutex);
+        m_grid = std::move(next);
+        ++m_version;
+        if (comparable) {
+            m_changes.push_back(GridChange{m_version, std::move(changed)});
+            if (m_changes.size() > max_change_history) {
+                m_changes.pop_front();
+            }
+        } else {
+            m_changes.clear();
+        }
+    }
+
+    void forget(GridCell goal) {
+        std::lock_guard lock(m_mutex);
+        if (m_grid->in_bounds(goal)) {
+            m_cache.erase(m_grid->index(goal));
+        }
+    }
+
+    [[nodiscard]] std::shared_ptr<const NavigationGrid> grid() const {
+        std::lock_guard lock(m_mutex);
+        return m_grid;
+    }
+};
+
+// A* dla celów unikalnych (jeden agent). Bufory są trzymane między zapytaniami,
+// a znaczniki odwiedzin eliminują czyszczenie tablic przy każdym wyszukiwaniu.
+class AStarPathfinder {
+private:
+    using OpenEntry = std::pair<std::uint32_t, std::uint32_t>; // f, indeks
+
+    std::vector<std::uint32_t> m_cost{};
+    std::vector<std::uint32_t> m_parent{};
+    std::vector<std::uint32_t> m_stamp{};
+    std::vector<OpenEntry> m_open{};
+    std::uint32_t m_search{0};
+
+    static constexpr std::uint32_t heuristic(GridCell a, GridCell b) noexcept {
+        const auto dx = static_cast<std::uint32_t>(a.x > b.x ? a.x - b.x : b.x - a.x);
+        const auto dy = static_cast<std::uint32_t>(a.y > b.y ? a.y - b.y : b.y - a.y);
+        return navigation::straight_cost * std::max(dx, dy) +
+               (navigation::diagonal_cost - navigation::straight_cost) * std::min(dx, dy);
+    }
+
+public:
+    // Ścieżka od start do goal włącznie. false gdy cel nieosiągalny.
+    [[nodiscard]] bool find_path(const NavigationGrid &grid, GridCell start, GridCell goal,
+                                 std::vector<GridCell> &path) {
+        path.clear();
+        if (grid.is_blocked(start) || grid.is_blocked(goal)) {
+            return false;
+        }
+
+        if (m_stamp.size() != grid.cell_count()) {
+            m_cost.assign(grid.cell_count(), navigation::unreachable);
+            m_parent.assign(grid.cell_count(), 0);
+            m_stamp.assign(grid.cell_count(), 0);
+            m_search = 0;
+        }
+        if (++m_search == 0) {
+            std::ranges::fill(m_stamp, 0);
+            m_search = 1;
+        }
+
+        auto cost_of = [this](std::uint32_t i) {
+            return m_stamp[i] == m_search ? m_cost[i] : navigation::unreachable;
+        };
+
+        const auto start_index = grid.index(start);
+        const auto goal_index = grid.index(goal);
+        m_open.clear();
+        m_stamp[start_index] = m_search;
+        m_cost[start_index] = 0;
+        m_parent[start_index] = start_index;
+        m_open.emplace_back(heuristic(start, goal), start_index);
+
+        while (!m_open.empty()) {
+            std::ranges::pop_heap(m_open, std::greater<>{});
+            const auto [f, current] = m_open.back();
+            m_open.pop_back();
+
+            const GridCell from = grid.cell(current);
+            if (current == goal_index) {
+                for (auto i = goal_index; ; i = m_parent[i]) {
+                    path.push_back(grid.cell(i));
+                    if (i == start_index) break;
+                }
+                std::ranges::reverse(path);
+                return true;
+            }
+            if (f > m_cost[current] + heuristic(from, goal)) continue;
+
+            for (const auto &offset: navigation::neighbours) {
+                if (!grid.can_step(from, offset)) continue;
+                const GridCell to{from.x + offset.dx, from.y + offset.dy};
+                const auto next = grid.index(to);
+                const auto next_cost = m_cost[current] + offset.cost;
+                if (next_cost < cost_of(next)) {
+                    m_stamp[next] = m_search;
+                    m_cost[next] = next_cost;
+                    m_parent[next] = current;
+                    m_open.emplace_back(next_cost + heuristic(to, goal), next);
+                    std::ranges::push_heap(m_open, std::greater<>{});
+                }
+            }
+        }
+        return false;
+    }
+};
+
+#endif //SDLPATHFINDING_HPP
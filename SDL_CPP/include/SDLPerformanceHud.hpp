@@ -0,0 +1,308 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLPERFORMANCEHUD_HPP
+#define SDLPERFORMANCEHUD_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string_view>
+#include <vector>
+#include <SDL3/SDL.h>
+
+#include "SDLAllocationTracker.hpp"
+
+// Fazy klatki mierzone przez HUD
+enum class FramePhase : std::uint8_t {
+    Events = 0,
+    Update,
+    Render,
+    Present,
+    Count
+};
+
+inline constexpr std::size_t frame_phase_count = static_cast<std::size_t>(FramePhase::Count);
+static_assert(frame_phase_count < AllocationTracker::max_scopes, "Fazy muszą mieścić się w scope alokatora");
+
+constexpr std::string_view get_phase_name(FramePhase phase) noexcept {
+    switch (phase) {
+        case FramePhase::Events: return "events";
+        case FramePhase::Update: return "update";
+        case FramePhase::Render: return "render";
+        case FramePhase::Present: return "present";
+        case FramePhase::Count: break;
+    }
+    return "unknown";
+}
+
+struct FrameSample {
+    float frame_ms{0};
+    std::array<float, frame_phase_count> phase_ms{};
+    std::uint32_t draw_calls{0};
+    std::uint32_t sprites{0};
+    AllocationStats allocations{};
+};
+
+// Ring buffer ostatnich klatek - stały rozmiar, bez alokacji
+template<std::size_t Capacity>
+class FrameHistory {
+private:
+    std::array<FrameSample, Capacity> m_samples{};
+    std::size_t m_head{0};
+    std::size_t m_size{0};
+
+public:
+    constexpr void push(const FrameSample &sample) noexcept {
+        m_samples[m_head] = sample;
+        m_head = (m_head + 1) % Capacity;
+        m_size = std::min(m_size + 1, Capacity);
+    }
+
+    // age == 0 to najnowsza klatka
+    [[nodiscard]] constexpr const FrameSample &at_age(std::size_t age) const noexcept {
+        return m_samples[(m_head + Capacity - 1 - age) % Capacity];
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+};
+
+// Nakładka z metrykami wydajności (F3 przełącza widoczność)
+class PerformanceHud {
+public:
+    static constexpr std::size_t history_size{120};
+
+private:
+    static constexpr float budget_ms{1000.0f / 60.0f};
+    static constexpr float graph_max_ms{budget_ms * 2.0f};
+    static constexpr float bar_width{2.0f};
+    static constexpr float graph_height{48.0f};
+    static constexpr float margin{4.0f};
+    static constexpr float line_height{SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE + 2.0f};
+    static constexpr std::size_t text_lines{5};
+    // Panel + linia budżetu + słupki wykresu
+    static constexpr std::size_t max_quads{2 + history_size};
+
+    FrameHistory<history_size> m_history{};
+    FrameSample m_current{};
+    Uint64 m_frame_start{0};
+    double m_ticks_to_ms{0};
+    std::size_t m_texture_bytes{0};
+    bool m_visible{false};
+    std::vector<SDL_Vertex> m_vertices{};
+    std::vector<int> m_indices{};
+
+    void push_quad(float x, float y, float w, float h, SDL_FColor color) {
+        const int base = static_cast<int>(m_vertices.size());
+        m_vertices.push_back({{x, y}, color, {0, 0}});
+        m_vertices.push_back({{x + w, y}, color, {0, 0}});
+        m_vertices.push_back({{x + w, y + h}, color, {0, 0}});
+        m_vertices.push_back({{x, y + h}, color, {0, 0}});
+        for (const int offset: {0, 1, 2, 0, 2, 3}) {
+            m_indices.push_back(base + offset);
+        }
+    }
+
+    static constexpr SDL_FColor bar_color(float frame_ms) noexcept {
+        if (frame_ms <= budget_ms) return {0.2f, 0.9f, 0.3f, 0.9f};
+        if (frame_ms <= graph_max_ms) return {0.95f, 0.8f, 0.2f, 0.9f};
+        return {0.95f, 0.25f, 0.2f, 0.9f};
+    }
+
+    void draw_text_line(SDL_Renderer *renderer, float x, float &y, const char *text) const noexcept {
+        SDL_RenderDebugText(renderer, x, y, text);
+        y += line_height;
+    }
+
+public:
+    PerformanceHud()
+        : m_ticks_to_ms(1000.0 / static_cast<double>(SDL_GetPerformanceFrequency())) {
+        // Bufory geometrii rezerwowane raz - draw() nie alokuje
+        m_vertices.reserve(max_quads * 4);
+        m_indices.reserve(max_quads * 6);
+    }
+
+    // Zamyka poprzednią klatkę i zapisuje ją do historii
+    void begin_frame() noexcept {
+        const Uint64 now = SDL_GetPerformanceCounter();
+        if (m_frame_start != 0) [[likely]] {
+            m_current.frame_ms = static_cast<float>(static_cast<double>(now - m_frame_start) * m_ticks_to_ms);
+            m_current.allocations = AllocationTracker::last_frame();
+            m_history.push(m_current);
+        }
+        m_current = FrameSample{};
+        m_frame_start = now;
+    }
+
+    void add_phase_time(FramePhase phase, Uint64 ticks) noexcept {
+        m_current.phase_ms[static_cast<std::size_t>(phase)] +=
+                static_cast<float>(static_cast<double>(ticks) * m_ticks_to_ms);
+    }
+
+    void count_draw_call(std::uint32_t sprites = 1) noexcept {
+        ++m_current.draw_calls;
+        m_current.sprites += sprites;
+    }
+
+    void track_texture(const SDL_Texture *texture) noexcept {
+        if (!texture) return;
+        m_texture_bytes += static_cast<std::size_t>(texture->w) * texture->h * SDL_BYTESPERPIXEL(texture->format);
+    }
+
+    void untrack_texture(const SDL_Texture *texture) noexcept {
+        if (!texture) return;
+        const auto bytes = static_cast<std::size_t>(texture->w) * texture->h * SDL_BYTESPERPIXEL(texture->format);
+        m_texture_bytes -= std::min(bytes, m_texture_bytes);
+    }
+
+    void toggle() noexcept {
+        m_visible = !m_visible;
+    }
+
+    [[nodiscard]] constexpr bool is_visible() const noexcept {
+        return m_visible;
+    }
+
+    [[nodiscard]] constexpr const FrameHistory<history_size> &history() const noexcept {
+        return m_history;
+    }
+
+    // SDL buduje atlas czcionki debug i bufory geometrii leniwie przy pierwszym użyciu.
+    // Wywołane w inicjalizacji - pierwsze F3 w steady-state już nie alokuje.
+    void warm_up(SDL_Renderer *renderer) noexcept {
+        if (!renderer) {
+            return;
+        }
+
+        m_vertices.clear();
+        m_indices.clear();
+        for (std::size_t quad = 0; quad < max_quads; ++quad) {
+            push_quad(0, 0, 0, 0, {0.0f, 0.0f, 0.0f, 0.0f});
+        }
+        SDL_RenderGeometry(renderer, nullptr,
+                           m_vertices.data(), static_cast<int>(m_vertices.size()),
+                           m_indices.data(), static_cast<int>(m_indices.size()));
+
+        // Pełna długość linii HUD
+        std::array<char, 96> line{};
+        line.fill('#');
+        line.back() = '\0';
+        float y = margin;
+        for (std::size_t i = 0; i < text_lines; ++i) {
+            draw_text_line(renderer, margin, y, line.data());
+        }
+    }
+
+    // Rysowane po scenie, przed SDL_RenderPresent. Wszystkie prostokąty idą jednym SDL_RenderGeometry.
+    void draw(SDL_Renderer *renderer) noexcept {
+        if (!m_visible || !renderer || m_history.size() == 0) {
+            return;
+        }
+
+        // Średnie z całej historii
+        float total_ms = 0;
+        std::array<float, frame_phase_count> phase_total{};
+        for (std::size_t age = 0; age < m_history.size(); ++age) {
+            const auto &sample = m_history.at_age(age);
+            total_ms += sample.frame_ms;
+            for (std::size_t phase = 0; phase < frame_phase_count; ++phase) {
+                phase_total[phase] += sample.phase_ms[phase];
+            }
+        }
+        const float count = static_cast<float>(m_history.size());
+        const float avg_ms = total_ms / count;
+        const float fps = avg_ms > 0 ? 1000.0f / avg_ms : 0;
+        const auto &latest = m_history.at_age(0);
+
+        const float panel_w = history_size * bar_width + margin * 2;
+        const float graph_top = margin + text_lines * line_height + margin;
+        const float panel_h = graph_top + graph_height + margin;
+
+        m_vertices.clear();
+        m_indices.clear();
+        push_quad(0, 0, panel_w, panel_h, {0.0f, 0.0f, 0.0f, 0.6f});
+
+        const float graph_bottom = graph_top + graph_height;
+        const float budget_y = graph_bottom - graph_height * (budget_ms / graph_max_ms);
+        push_quad(margin, budget_y, history_size * bar_width, 1.0f, {1.0f, 1.0f, 1.0f, 0.35f});
+
+        // Najstarsza klatka po lewej
+        for (std::size_t age = 0; age < m_history.size(); ++age) {
+            const float frame_ms = m_history.at_age(age).frame_ms;
+            const float h = graph_height * std::min(frame_ms / graph_max_ms, 1.0f);
+            const float x = margin + static_cast<float>(history_size - 1 - age) * bar_width;
+            push_quad(x, graph_bottom - h, bar_width, h, bar_color(frame_ms));
+        }
+
+        Uint8 r{}, g{}, b{}, a{};
+        SDL_BlendMode blend_mode{SDL_BLENDMODE_NONE};
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+        SDL_GetRenderDrawBlendMode(renderer, &blend_mode);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+        SDL_RenderGeometry(renderer, nullptr,
+                           m_vertices.data(), static_cast<int>(m_vertices.size()),
+                           m_indices.data(), static_cast<int>(m_indices.size()));
+
+        // Bufor na stosie - formatowanie bez alokacji
+        std::array<char, 96> line{};
+        auto format_line = [&line]<typename... Args>(std::format_string<Args...> fmt, Args &&... args) {
+            auto result = std::format_to_n(line.data(), line.size() - 1, fmt, std::forward<Args>(args)...);
+            *result.out = '\0';
+            return line.data();
+        };
+
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        float y = margin;
+        draw_text_line(renderer, margin, y, format_line("FPS {:.1f} ({:.2f} ms)", fps, avg_ms));
+        draw_text_line(renderer, margin, y, format_line("ev {:.2f} up {:.2f} rn {:.2f} pr {:.2f}",
+                                                        phase_total[0] / count, phase_total[1] / count,
+                                                        phase_total[2] / count, phase_total[3] / count));
+        draw_text_line(renderer, margin, y, format_line("draws {} sprites {}",
+                                                        latest.draw_calls, latest.sprites));
+        draw_text_line(renderer, margin, y, format_line("tex {:.1f} KiB",
+                                                        static_cast<double>(m_texture_bytes) / 1024.0));
+        if constexpr (AllocationTracker::enabled()) {
+            draw_text_line(renderer, margin, y, format_line("alloc {} ({} B) strict {}",
+                                                            latest.allocations.count, latest.allocations.bytes,
+                                                            AllocationTracker::steady_state_violations()));
+        } else {
+            draw_text_line(renderer, margin, y, "alloc: tracking off");
+        }
+
+        SDL_SetRenderDrawBlendMode(renderer, blend_mode);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    }
+};
+
+// RAII pomiar fazy klatki, alokacje w środku są przypisywane do tej fazy
+class ScopedPhaseTimer {
+private:
+    PerformanceHud &m_hud;
+    FramePhase m_phase;
+    AllocationScope m_allocation_scope;
+    Uint64 m_start;
+
+public:
+    ScopedPhaseTimer(PerformanceHud &hud, FramePhase phase) noexcept
+        : m_hud(hud), m_phase(phase), m_allocation_scope(static_cast<std::uint8_t>(phase)),
+          m_start(SDL_GetPerformanceCounter()) {
+    }
+
+    ~ScopedPhaseTimer() noexcept {
+        m_hud.add_phase_time(m_phase, SDL_GetPerformanceCounter() - m_start);
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+    ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+};
+
+#endif //SDLPERFORMANCEHUD_HPP
@@ -23,6 +23,7 @@ using SDL_WindowPtr = SDL_UniquePtr<SDL_Window>;
 using SDL_RendererPtr = SDL_UniquePtr<SDL_Renderer>;
 using SDL_TexturePtr = SDL_UniquePtr<SDL_Texture>;
 using SDL_SurfacePtr = SDL_UniquePtr<SDL_Surface>;
+using SDL_AudioStreamPtr = SDL_UniquePtr<SDL_AudioStream>;
 
 using SDL_WindowSharedPtr = SDL_SharedPtr<SDL_Window>;
 using SDL_RendererSharedPtr = SDL_SharedPtr<SDL_Renderer>;
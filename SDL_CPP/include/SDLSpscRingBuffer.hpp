@@ -0,0 +1,90 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLSPSCRINGBUFFER_HPP
+#define SDLSPSCRINGBUFFER_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+// Lock-free kolejka jeden producent / jeden konsument.
+// Pojemność musi być potęgą dwójki, indeksy rosną monotonicznie i są maskowane.
+template<typename T, std::size_t Capacity>
+    requires (Capacity > 0 && (Capacity & (Capacity - 1)) == 0 && std::is_trivially_copyable_v<T>)
+class SpscRingBuffer {
+private:
+    static constexpr std::size_t mask{Capacity - 1};
+    // Osobne linie cache dla producenta i konsumenta - bez false sharingu
+    static constexpr std::size_t cache_line{64};
+
+    alignas(cache_line) std::atomic<std::size_t> m_head{0}; // zapis - producent
+    alignas(cache_line) std::atomic<std::size_t> m_tail{0}; // odczyt - konsument
+    alignas(cache_line) std::array<T, Capacity> m_data{};
+
+public:
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+    // Przybliżone poza wątkami producenta/konsumenta
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t free_space() const noexcept {
+        return Capacity - size();
+    }
+
+    // Producent
+    [[nodiscard]] bool try_push(const T &value) noexcept {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_data[head & mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producent: zapisuje ile się zmieści, zwraca liczbę zapisanych elementów
+    std::size_t write(std::span<const T> values) noexcept {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        const auto free = Capacity - (head - m_tail.load(std::memory_order_acquire));
+        const auto count = std::min(free, values.size());
+        const auto first = std::min(count, Capacity - (head & mask));
+        std::copy_n(values.begin(), first, m_data.begin() + (head & mask));
+        std::copy_n(values.begin() + first, count - first, m_data.begin());
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Konsument
+    [[nodiscard]] std::optional<T> try_pop() noexcept {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        T value = m_data[tail & mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Konsument: odczytuje ile jest dostępne, zwraca liczbę odczytanych elementów
+    std::size_t read(std::span<T> out) noexcept {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        const auto available = m_head.load(std::memory_order_acquire) - tail;
+        const auto count = std::min(available, out.size());
+        const auto first = std::min(count, Capacity - (tail & mask));
+        std::copy_n(m_data.begin() + (tail & mask), first, out.begin());
+        std::copy_n(m_data.begin(), count - first, out.begin() + first);
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+};
+
+#endif //SDLSPSCRINGBUFFER_HPP
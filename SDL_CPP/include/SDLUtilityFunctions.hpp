@@ -5,10 +5,10 @@
 #ifndef SDLUTILITYFUNCTIONS_HPP
 #define SDLUTILITYFUNCTIONS_HPP
 #include <format>
-#include <iostream>
 #include <utility>
 #include <xmmintrin.h>
 
+#include "SDLLogger.hpp"
 #include "SDLResourcesConcepts.hpp"
 
 // POPRAWKA: Bezpieczne renderowanie
@@ -67,7 +67,7 @@ template<typename EventType>
 constexpr void handleEvent(const EventType &event) noexcept {
     if constexpr (requires { event.type; event.key; }) {
         if (event.type == SDL_EVENT_KEY_DOWN) {
-            std::cout << std::format("⌨️  Klawisz: {}\n", static_cast<int>(event.key.key));
+            log_debug("⌨️  Klawisz: {}", static_cast<int>(event.key.key));
         }
     }
 }
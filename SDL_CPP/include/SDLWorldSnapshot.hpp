@@ -0,0 +1,159 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLWORLDSNAPSHOT_HPP
+#define SDLWORLDSNAPSHOT_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+enum class SnapshotEncoding : std::uint8_t {
+    // Każda klatka to pełna kopia świata
+    Full,
+    // Pełna jest tylko najnowsza klatka, starsze to łatki cofające zmienione słowa 64-bit
+    Delta,
+};
+
+// Pierścień migawek świata symulacji w pamięci zaalokowanej raz w konstruktorze.
+// save() i restore() nie alokują. World musi być trivially copyable (bloby SoA kopiowane memcpy).
+template<typename World, std::size_t Depth = 8>
+    requires (std::is_trivially_copyable_v<World> && Depth > 0)
+class WorldSnapshotRing {
+private:
+    using Word = std::uint64_t;
+    static_assert(sizeof(World) % sizeof(Word) == 0, "World musi mieć rozmiar wielokrotności 8 bajtów");
+    static constexpr std::size_t word_count{sizeof(World) / sizeof(Word)};
+
+    struct PatchEntry {
+        std::uint32_t index;
+        Word value;
+    };
+
+    SnapshotEncoding m_encoding;
+    // Full: Depth pełnych bloków. Delta: najnowszy stan + Depth - 1 łatek.
+    std::unique_ptr<Word[]> m_blocks;
+    std::unique_ptr<PatchEntry[]> m_patches;
+    std::array<std::size_t, Depth> m_patch_sizes{};
+    std::size_t m_newest{0};
+    std::size_t m_size{0};
+
+    [[nodiscard]] Word *full_block(std::size_t slot) const noexcept {
+        return m_blocks.get() + slot * word_count;
+    }
+
+    [[nodiscard]] PatchEntry *patch(std::size_t slot) const noexcept {
+        return m_patches.get() + slot * word_count;
+    }
+
+    // Slot klatki sprzed frames_back klatek
+    [[nodiscard]] std::size_t slot_of(std::size_t frames_back) const noexcept {
+        return (m_newest + Depth - frames_back) % Depth;
+    }
+
+    // memcpy po słowach - bez aliasowania World przez Word
+    static void apply_patch(World &world, const PatchEntry *entries, std::size_t count) noexcept {
+        auto *bytes = reinterpret_cast<std::byte *>(&world);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(bytes + entries[i].index * sizeof(Word), &entries[i].value, sizeof(Word));
+        }
+    }
+
+public:
+    explicit WorldSnapshotRing(SnapshotEncoding encoding = SnapshotEncoding::Full)
+        : m_encoding(encoding),
+          m_blocks(std::make_unique<Word[]>(encoding == SnapshotEncoding::Full ? Depth * word_count : word_count)),
+          m_patches(encoding == SnapshotEncoding::Delta ? std::make_unique<PatchEntry[]>(Depth * word_count) : nullptr) {
+    }
+
+    [[nodiscard]] static constexpr std::size_t depth() noexcept {
+        return Depth;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] SnapshotEncoding encoding() const noexcept {
+        return m_encoding;
+    }
+
+    // Bajty faktycznie zajęte przez zapisane klatki
+    [[nodiscard]] std::size_t stored_bytes() const noexcept {
+        if (m_size == 0) return 0;
+        if (m_encoding == SnapshotEncoding::Full) {
+            return m_size * sizeof(World);
+        }
+        std::size_t bytes = sizeof(World);
+        for (std::size_t back = 1; back < m_size; ++back) {
+            bytes += m_patch_sizes[slot_of(back)] * sizeof(PatchEntry);
+        }
+        return bytes;
+    }
+
+    void clear() noexcept {
+        m_size = 0;
+    }
+
+    void save(const World &world) noexcept {
+        if (m_encoding == SnapshotEncoding::Full) {
+            m_newest = m_size == 0 ? 0 : (m_newest + 1) % Depth;
+            std::memcpy(full_block(m_newest), &world, sizeof(World));
+        } else {
+            Word *head = full_block(0);
+            if (m_size > 0) {
+                // Łatka dla dotychczasowej najnowszej klatki: stare wartości słów, które się zmieniły
+                const auto *bytes = reinterpret_cast<const std::byte *>(&world);
+                PatchEntry *entries = patch(m_newest);
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < word_count; ++i) {
+                    Word incoming;
+                    std::memcpy(&incoming, bytes + i * sizeof(Word), sizeof(Word));
+                    if (head[i] != incoming) {
+                        entries[count++] = PatchEntry{static_cast<std::uint32_t>(i), head[i]};
+                    }
+                }
+                m_patch_sizes[m_newest] = count;
+                m_newest = (m_newest + 1) % Depth;
+            }
+            std::memcpy(head, &world, sizeof(World));
+        }
+        m_size = m_size < Depth ? m_size + 1 : Depth;
+    }
+
+    // frames_back == 0 to ostatnio zapisana klatka. O(rozmiar stanu), bez alokacji.
+    [[nodiscard]] bool restore(std::size_t frames_back, World &out) const noexcept {
+        if (frames_back >= m_size) {
+            return false;
+        }
+        if (m_encoding == SnapshotEncoding::Full) {
+            std::memcpy(static_cast<void *>(&out), full_block(slot_of(frames_back)), sizeof(World));
+            return true;
+        }
+
+        std::memcpy(static_cast<void *>(&out), full_block(0), sizeof(World));
+        for (std::size_t back = 1; back <= frames_back; ++back) {
+            const auto slot = slot_of(back);
+            apply_patch(out, patch(slot), m_patch_sizes[slot]);
+        }
+        return true;
+    }
+
+    // Cofa się o jedną klatkę: out = poprzednia klatka, najnowsza zostaje usunięta
+    [[nodiscard]] bool rewind(World &out) noexcept {
+        if (!restore(1, out)) {
+            return false;
+        }
+        if (m_encoding == SnapshotEncoding::Delta) {
+            std::memcpy(full_block(0), &out, sizeof(World));
+        }
+        m_newest = (m_newest + Depth - 1) % Depth;
+        --m_size;
+        return true;
+    }
+};
+
+#endif //SDLWORLDSNAPSHOT_HPP
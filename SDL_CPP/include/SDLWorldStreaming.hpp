@@ -0,0 +1,795 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#ifndef SDLWORLDSTREAMING_HPP
+#define SDLWORLDSTREAMING_HPP
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <tileson.h>
+
+#include "SDLArgumentsStructure.hpp"
+#include "SDLError.hpp"
+#include "SDLLogger.hpp"
+#include "SDLPerformanceHud.hpp"
+#include "SDLResourcesAliases.hpp"
+
+struct RegionCoord {
+    int x{0};
+    int y{0};
+
+    constexpr bool operator==(const RegionCoord &) const noexcept = default;
+};
+
+// Obiekt z warstwy obiektów Tiled należący do regionu
+struct RegionEntity {
+    std::uint32_t id{0};
+    std::string name{};
+    SDL_FRect bounds{};
+};
+
+struct RegionStats {
+    RegionCoord coord{};
+    std::size_t resident_bytes{0};
+    float load_latency_ms{0};
+};
+
+struct StreamingStats {
+    std::size_t resident_regions{0};
+    // Ładowane albo czekające na upload - bez regionów wstrzymanych przez limit pamięci
+    std::size_t pending_regions{0};
+    // Wstrzymane przez limit - czekają, aż dalekie regiony zwolnią miejsce, i nie ładują niczego
+    std::size_t deferred_regions{0};
+    std::size_t region_bytes{0};
+    std::size_t texture_bytes{0};
+    // Zdekodowane powierzchnie w drodze do uploadu - też liczą się do limitu pamięci
+    std::size_t surface_bytes{0};
+    std::uint64_t evictions{0};
+    std::uint64_t deferred_by_cap{0};
+    float last_load_latency_ms{0};
+    float max_load_latency_ms{0};
+};
+
+// Streaming dużych map Tiled regionami wokół kamery.
+// Wątek roboczy wycina kafelki/encje regionu i dekoduje obrazy tilesetów do SDL_Surface,
+// tekstury powstają wyłącznie w pump_uploads() na wątku renderującym.
+// Limit memory_cap_bytes obejmuje dane regionów, tekstury i powierzchnie w drodze - wątek roboczy
+// rezerwuje bajty przed oddaniem powierzchni, więc suma nigdy go nie przekracza.
+class WorldStreamer {
+private:
+    enum class RegionState : std::uint8_t {
+        Unloaded,
+        Loading,
+        Ready,
+        Resident,
+    };
+
+    // Stan tilesetu współdzielony z wątkiem roboczym.
+    // Decoding = powierzchnia u wątku roboczego albo w jednym z regionów czekających na upload.
+    enum class TilesetState : std::uint8_t {
+        Absent,
+        Decoding,
+        Resident,
+        Failed,
+    };
+
+    struct TilesetSlot {
+        std::filesystem::path image{};
+        std::uint32_t first_gid{1};
+        int columns{1};
+        int tile_width{0};
+        int tile_height{0};
+        int margin{0};
+        int spacing{0};
+        SDL_TexturePtr texture{};
+        std::size_t bytes{0};
+        std::uint32_t refs{0};
+        std::atomic<TilesetState> state{TilesetState::Absent};
+        // Rozmiar po ostatnim dekodowaniu - szacunek przy ponownym zleceniu
+        std::atomic<std::size_t> decoded_bytes{0};
+    };
+
+    struct LoadedRegion {
+        std::uint32_t region{0};
+        std::uint64_t generation{0};
+        std::vector<std::vector<std::uint32_t> > layers{};
+        std::vector<RegionEntity> entities{};
+        std::vector<std::uint16_t> tilesets{};
+        std::vector<std::pair<std::uint16_t, SDL_SurfacePtr> > surfaces{};
+        std::size_t bytes{0};
+    };
+
+    struct Region {
+        RegionState state{RegionState::Unloaded};
+        std::uint64_t generation{0};
+        Uint64 requested_ticks{0};
+        float load_latency_ms{0};
+        // Czeka na miejsce w limicie - deferred_by_cap liczy jedno wstrzymanie na ładowanie
+        bool deferred{false};
+        std::unique_ptr<LoadedRegion> data{};
+    };
+
+    // Kafelki jednego tilesetu w jednej warstwie - jedno SDL_RenderGeometry
+    struct TileBatch {
+        std::vector<SDL_Vertex> vertices{};
+        std::vector<int> indices{};
+    };
+
+    static constexpr std::uint32_t gid_mask{0x1FFFFFFF};
+
+    std::unique_ptr<tson::Map> m_map;
+    std::filesystem::path m_base_dir;
+    StreamingConfig m_config;
+    int m_map_width;
+    int m_map_height;
+    int m_tile_width;
+    int m_tile_height;
+    int m_regions_x;
+    int m_regions_y;
+    std::vector<Region> m_regions{};
+    std::vector<std::uint32_t> m_active{};
+    std::vector<std::unique_ptr<LoadedRegion> > m_ready{};
+    std::vector<tson::Layer *> m_tile_layers{};
+    std::vector<tson::Layer *> m_object_layers{};
+    std::vector<std::unique_ptr<TilesetSlot> > m_tilesets{};
+    std::vector<TileBatch> m_batches{};
+    SDL_FPoint m_camera{};
+    StreamingStats m_stats{};
+    PerformanceHud *m_hud;
+    double m_ticks_to_ms;
+    // Dane regionów + tekstury + powierzchnie w drodze; rezerwują oba wątki
+    std::atomic<std::size_t> m_used_bytes{0};
+
+    std::mutex m_mutex{};
+    std::condition_variable_any m_condition{};
+    std::vector<std::pair<std::uint32_t, std::uint64_t> > m_jobs{};
+    std::vector<std::unique_ptr<LoadedRegion> > m_completed{};
+    std::vector<std::unique_ptr<LoadedRegion> > m_incoming{};
+    std::jthread m_worker{};
+
+    void collect_layers(std::vector<tson::Layer> &layers) {
+        for (auto &layer: layers) {
+            switch (layer.getType()) {
+                case tson::LayerType::Group: collect_layers(layer.getLayers()); break;
+                case tson::LayerType::TileLayer: m_tile_layers.push_back(&layer); break;
+                case tson::LayerType::ObjectGroup: m_object_layers.push_back(&layer); break;
+                default: break;
+            }
+        }
+    }
+
+    [[nodiscard]] RegionCoord coord_of(std::uint32_t region) const noexcept {
+        return {static_cast<int>(region % m_regions_x), static_cast<int>(region / m_regions_x)};
+    }
+
+    [[nodiscard]] SDL_FRect bounds_of(RegionCoord coord) const noexcept {
+        const float w = static_cast<float>(m_config.region_tiles * m_tile_width);
+        const float h = static_cast<float>(m_config.region_tiles * m_tile_height);
+        return {static_cast<float>(coord.x) * w, static_cast<float>(coord.y) * h, w, h};
+    }
+
+    // Odległość kamery od najbliższego punktu regionu
+    [[nodiscard]] float distance_to(std::uint32_t region) const noexcept {
+        const auto bounds = bounds_of(coord_of(region));
+        const float dx = std::max({bounds.x - m_camera.x, 0.0f, m_camera.x - (bounds.x + bounds.w)});
+        const float dy = std::max({bounds.y - m_camera.y, 0.0f, m_camera.y - (bounds.y + bounds.h)});
+        return std::hypot(dx, dy);
+    }
+
+    [[nodiscard]] std::size_t tileset_of(std::uint32_t gid) const noexcept {
+        // Tilesety są posortowane po first_gid
+        const auto it = std::upper_bound(m_tilesets.begin(), m_tilesets.end(), gid,
+                                         [](std::uint32_t value, const auto &slot) {
+                                             return value < slot->first_gid;
+                                         });
+        return it == m_tilesets.begin() ? 0 : static_cast<std::size_t>(it - m_tilesets.begin() - 1);
+    }
+
+    [[nodiscard]] static std::size_t surface_size(const SDL_Surface *surface) noexcept {
+        return static_cast<std::size_t>(surface->w) * surface->h * SDL_BYTESPERPIXEL(surface->format);
+    }
+
+    // Rezerwacja w limicie pamięci - false gdy się nie mieści
+    [[nodiscard]] bool reserve(std::size_t bytes) noexcept {
+        auto used = m_used_bytes.load();
+        do {
+            if (used + bytes > m_config.memory_cap_bytes) return false;
+        } while (!m_used_bytes.compare_exchange_weak(used, used + bytes));
+        return true;
+    }
+
+    // Wątek roboczy: mapa jest tylko czytana, wątek gry jej nie modyfikuje
+    [[nodiscard]] std::unique_ptr<LoadedRegion> load_region(std::uint32_t region, std::uint64_t generation) {
+        auto loaded = std::make_unique<LoadedRegion>();
+        loaded->region = region;
+        loaded->generation = generation;
+
+        const auto coord = coord_of(region);
+        const int x0 = coord.x * m_config.region_tiles;
+        const int y0 = coord.y * m_config.region_tiles;
+        const int w = std::min(m_config.region_tiles, m_map_width - x0);
+        const int h = std::min(m_config.region_tiles, m_map_height - y0);
+
+        std::vector<std::uint8_t> used(m_tilesets.size(), 0);
+        loaded->layers.resize(m_tile_layers.size());
+        for (std::size_t l = 0; l < m_tile_layers.size(); ++l) {
+            const auto &data = m_tile_layers[l]->getData();
+            auto &tiles = loaded->layers[l];
+            tiles.assign(static_cast<std::size_t>(w) * h, 0);
+            for (int ty = 0; ty < h; ++ty) {
+                for (int tx = 0; tx < w; ++tx) {
+                    const auto source = static_cast<std::size_t>(y0 + ty) * m_map_width + (x0 + tx);
+                    if (source >= data.size()) continue;
+                    const auto gid = data[source] & gid_mask;
+                    tiles[static_cast<std::size_t>(ty) * w + tx] = gid;
+                    if (gid != 0 && !m_tilesets.empty()) used[tileset_of(gid)] = 1;
+                }
+            }
+            loaded->bytes += tiles.size() * sizeof(std::uint32_t);
+        }
+
+        const auto bounds = bounds_of(coord);
+        for (auto *layer: m_object_layers) {
+            for (auto &object: layer->getObjects()) {
+                const auto &position = object.getPosition();
+                const auto x = static_cast<float>(position.x);
+                const auto y = static_cast<float>(position.y);
+                if (x < bounds.x || y < bounds.y || x >= bounds.x + bounds.w || y >= bounds.y + bounds.h) continue;
+                const auto &size = object.getSize();
+                auto &entity = loaded->entities.emplace_back(RegionEntity{
+                    static_cast<std::uint32_t>(object.getId()), object.getName(),
+                    {x, y, static_cast<float>(size.x), static_cast<float>(size.y)}
+                });
+                loaded->bytes += sizeof(RegionEntity) + entity.name.capacity();
+            }
+        }
+
+        // Dekodujemy tylko tilesety, których nikt jeszcze nie ma ani nie dekoduje
+        for (std::uint16_t t = 0; t < used.size(); ++t) {
+            if (!used[t]) continue;
+            loaded->tilesets.push_back(t);
+            auto &slot = *m_tilesets[t];
+            auto expected = TilesetState::Absent;
+            if (!slot.state.compare_exchange_strong(expected, TilesetState::Decoding)) continue;
+
+            SDL_SurfacePtr surface{IMG_Load(slot.image.string().c_str())};
+            if (!surface) {
+                // Failed zamiast Absent - uszkodzony plik nie wraca w kółko do kolejki
+                log_error("❌ Nie można załadować tilesetu {}: {}", slot.image.string(), SDL_GetError());
+                slot.state.store(TilesetState::Failed);
+                continue;
+            }
+            const auto bytes = surface_size(surface.get());
+            slot.decoded_bytes.store(bytes);
+            if (!reserve(bytes)) {
+                // Brak miejsca - try_upload() zwolni dalekie regiony i zleci dekodowanie ponownie
+                slot.state.store(TilesetState::Absent);
+                continue;
+            }
+            loaded->surfaces.emplace_back(t, std::move(surface));
+        }
+        return loaded;
+    }
+
+    void work(const std::stop_token &stop_token) {
+        while (true) {
+            std::unique_lock lock(m_mutex);
+            if (!m_condition.wait(lock, stop_token, [this] { return !m_jobs.empty(); })) {
+                return;
+            }
+            const auto [region, generation] = m_jobs.front();
+            m_jobs.erase(m_jobs.begin());
+            lock.unlock();
+
+            auto loaded = load_region(region, generation);
+
+            lock.lock();
+            m_completed.push_back(std::move(loaded));
+        }
+    }
+
+    void request_load(std::uint32_t index) {
+        auto &region = m_regions[index];
+        region.state = RegionState::Loading;
+        region.requested_ticks = SDL_GetPerformanceCounter();
+        m_active.push_back(index);
+        ++m_stats.pending_regions;
+        {
+            std::lock_guard lock(m_mutex);
+            m_jobs.emplace_back(index, region.generation);
+        }
+        m_condition.notify_one();
+    }
+
+    // Zwolnienie zdekodowanych, ale nieużytych powierzchni tilesetów
+    void release_surfaces(LoadedRegion &loaded) noexcept {
+        for (auto &[t, surface]: loaded.surfaces) {
+            m_used_bytes.fetch_sub(surface_size(surface.get()));
+            auto expected = TilesetState::Decoding;
+            m_tilesets[t]->state.compare_exchange_strong(expected, TilesetState::Absent);
+        }
+        loaded.surfaces.clear();
+    }
+
+    // Powierzchnia tilesetu z regionu albo z innego regionu czekającego w m_ready.
+    // Przekazanie między regionami: dwa regiony czekające nawzajem na swoje tilesety się nie blokują.
+    [[nodiscard]] SDL_SurfacePtr take_surface(std::uint16_t t, LoadedRegion &loaded) noexcept {
+        const auto take_from = [t](LoadedRegion &owner) -> SDL_SurfacePtr {
+            const auto it = std::ranges::find(owner.surfaces, t, [](const auto &entry) { return entry.first; });
+            if (it == owner.surfaces.end()) return {};
+            auto surface = std::move(it->second);
+            owner.surfaces.erase(it);
+            return surface;
+        };
+        if (auto surface = take_from(loaded)) return surface;
+        for (auto &other: m_ready) {
+            if (!other) continue;
+            if (auto surface = take_from(*other)) return surface;
+        }
+        return {};
+    }
+
+    [[nodiscard]] bool has_surface(std::uint16_t t, const LoadedRegion &loaded) const noexcept {
+        const auto holds = [t](const LoadedRegion &owner) {
+            return std::ranges::any_of(owner.surfaces, [t](const auto &entry) { return entry.first == t; });
+        };
+        return holds(loaded) || std::ranges::any_of(m_ready, [&holds](const auto &other) {
+            return other && holds(*other);
+        });
+    }
+
+    void evict(std::uint32_t index) {
+        auto &region = m_regions[index];
+        if (region.state == RegionState::Resident && region.data) {
+            for (const auto t: region.data->tilesets) {
+                auto &slot = *m_tilesets[t];
+                if (slot.refs > 0 && --slot.refs == 0 && slot.texture) {
+                    if (m_hud) m_hud->untrack_texture(slot.texture.get());
+                    slot.texture.reset();
+                    m_stats.texture_bytes -= slot.bytes;
+                    m_used_bytes.fetch_sub(slot.bytes);
+                    slot.bytes = 0;
+                    slot.state.store(TilesetState::Absent);
+                }
+            }
+            m_stats.region_bytes -= region.data->bytes;
+            m_used_bytes.fetch_sub(region.data->bytes);
+            --m_stats.resident_regions;
+            ++m_stats.evictions;
+        }
+        if (region.state == RegionState::Loading) {
+            std::lock_guard lock(m_mutex);
+            std::erase_if(m_jobs, [index](const auto &job) { return job.first == index; });
+        }
+        region.data.reset();
+        region.state = RegionState::Unloaded;
+        region.deferred = false;
+        // Nowa generacja unieważnia wyniki ładowania, które jeszcze są w drodze
+        ++region.generation;
+        std::erase(m_active, index);
+    }
+
+    // Twardy limit pamięci: zwalnia najdalsze regiony spoza promienia ładowania
+    [[nodiscard]] bool make_room(std::size_t needed) {
+        while (m_used_bytes.load() + needed > m_config.memory_cap_bytes) {
+            std::uint32_t farthest = 0;
+            float farthest_distance = m_config.load_radius;
+            bool found = false;
+            for (const auto index: m_active) {
+                if (m_regions[index].state != RegionState::Resident) continue;
+                const float distance = distance_to(index);
+                if (distance > farthest_distance) {
+                    farthest = index;
+                    farthest_distance = distance;
+                    found = true;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+            evict(farthest);
+        }
+        return true;
+    }
+
+    // Region czeka na miejsce: jego powierzchnie wracają do puli, żeby nie blokowały tilesetów
+    void defer(Region &region, LoadedRegion &loaded) noexcept {
+        if (!region.deferred) {
+            region.deferred = true;
+            ++m_stats.deferred_by_cap;
+            const auto coord = coord_of(loaded.region);
+            log_debug("Region ({}, {}) czeka na miejsce w limicie pamięci", coord.x, coord.y);
+        }
+        release_surfaces(loaded);
+    }
+
+    // Brakuje tekstury tilesetu (zwolniona po ewikcji, powierzchnia oddana przy wstrzymaniu) -
+    // region wraca do kolejki i wątek roboczy zdekoduje tileset ponownie
+    void requeue(std::unique_ptr<LoadedRegion> &loaded) {
+        const auto index = loaded->region;
+        auto &region = m_regions[index];
+        release_surfaces(*loaded);
+        loaded.reset();
+        region.state = RegionState::Loading;
+        {
+            std::lock_guard lock(m_mutex);
+            m_jobs.emplace_back(index, region.generation);
+        }
+        m_condition.notify_one();
+    }
+
+    // true gdy region trafił do pamięci rezydentnej, false gdy ma poczekać albo wrócił do kolejki
+    [[nodiscard]] bool try_upload(SDL_Renderer *renderer, std::unique_ptr<LoadedRegion> &loaded) {
+        auto &region = m_regions[loaded->region];
+
+        // Każdy tileset regionu musi mieć teksturę albo powierzchnię do uploadu
+        bool missing = false;
+        std::size_t missing_bytes = 0;
+        for (const auto t: loaded->tilesets) {
+            const auto &slot = *m_tilesets[t];
+            if (slot.texture || has_surface(t, *loaded)) continue;
+            switch (slot.state.load()) {
+                case TilesetState::Failed:
+                    continue;
+                case TilesetState::Decoding:
+                    // Powierzchnia jest jeszcze u wątku roboczego - trafi do m_ready w kolejnej klatce
+                    return false;
+                default:
+                    missing = true;
+                    missing_bytes += slot.decoded_bytes.load();
+                    break;
+            }
+        }
+
+        if (!make_room(loaded->bytes + missing_bytes)) {
+            defer(region, *loaded);
+            return false;
+        }
+        if (missing) {
+            requeue(loaded);
+            return false;
+        }
+        if (!reserve(loaded->bytes)) {
+            defer(region, *loaded);
+            return false;
+        }
+
+        for (const auto t: loaded->tilesets) {
+            auto &slot = *m_tilesets[t];
+            if (slot.texture) continue;
+            auto surface = take_surface(t, *loaded);
+            if (!surface) continue;
+            const auto bytes = surface_size(surface.get());
+            slot.texture.reset(SDL_CreateTextureFromSurface(renderer, surface.get()));
+            if (!slot.texture) {
+                log_error("❌ Tekstura tilesetu {}: {}", slot.image.string(), SDL_GetError());
+                m_used_bytes.fetch_sub(bytes);
+                slot.state.store(TilesetState::Failed);
+                continue;
+            }
+            // Bajty powierzchni przechodzą na teksturę - m_used_bytes bez zmian
+            SDL_SetTextureScaleMode(slot.texture.get(), SDL_SCALEMODE_NEAREST);
+            if (m_hud) m_hud->track_texture(slot.texture.get());
+            slot.bytes = bytes;
+            m_stats.texture_bytes += slot.bytes;
+            slot.state.store(TilesetState::Resident);
+        }
+        release_surfaces(*loaded);
+
+        for (const auto t: loaded->tilesets) {
+            ++m_tilesets[t]->refs;
+        }
+
+        region.load_latency_ms = static_cast<float>(
+            static_cast<double>(SDL_GetPerformanceCounter() - region.requested_ticks) * m_ticks_to_ms);
+        m_stats.last_load_latency_ms = region.load_latency_ms;
+        m_stats.max_load_latency_ms = std::max(m_stats.max_load_latency_ms, region.load_latency_ms);
+        m_stats.region_bytes += loaded->bytes;
+        ++m_stats.resident_regions;
+
+        region.data = std::move(loaded);
+        region.state = RegionState::Resident;
+        region.deferred = false;
+        return true;
+    }
+
+public:
+    WorldStreamer(std::unique_ptr<tson::Map> map, std::filesystem::path base_dir, const StreamingConfig &config,
+                  PerformanceHud *hud)
+        : m_map(std::move(map)), m_base_dir(std::move(base_dir)), m_config(config),
+          m_map_width(m_map->getSize().x), m_map_height(m_map->getSize().y),
+          m_tile_width(m_map->getTileSize().x), m_tile_height(m_map->getTileSize().y),
+          m_regions_x((m_map_width + config.region_tiles - 1) / config.region_tiles),
+          m_regions_y((m_map_height + config.region_tiles - 1) / config.region_tiles),
+          m_regions(static_cast<std::size_t>(m_regions_x) * m_regions_y),
+          m_hud(hud),
+          m_ticks_to_ms(1000.0 / static_cast<double>(SDL_GetPerformanceFrequency())) {
+        collect_layers(m_map->getLayers());
+
+        // Bufory na wszystkie regiony z góry - update() i pump_uploads() nie alokują same z siebie
+        m_active.reserve(m_regions.size());
+        m_ready.reserve(m_regions.size());
+        m_jobs.reserve(m_regions.size());
+        m_completed.reserve(m_regions.size());
+        m_incoming.reserve(m_regions.size());
+
+        for (auto &tileset: m_map->getTilesets()) {
+            auto slot = std::make_unique<TilesetSlot>();
+            slot->image = m_base_dir / tileset.getImagePath();
+            slot->first_gid = static_cast<std::uint32_t>(tileset.getFirstgid());
+            slot->columns = std::max(tileset.getColumns(), 1);
+            slot->tile_width = tileset.getTileSize().x;
+            slot->tile_height = tileset.getTileSize().y;
+            slot->margin = tileset.getMargin();
+            slot->spacing = tileset.getSpacing();
+            m_tilesets.push_back(std::move(slot));
+        }
+        std::ranges::sort(m_tilesets, {}, [](const auto &slot) { return slot->first_gid; });
+        m_batches.resize(m_tilesets.size());
+
+        m_worker = std::jthread([this](const std::stop_token &stop_token) { work(stop_token); });
+    }
+
+    ~WorldStreamer() noexcept {
+        // Wątek roboczy czyta mapę i tilesety - musi skończyć przed ich zniszczeniem
+        m_worker.request_stop();
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+        if (m_hud) {
+            for (const auto &slot: m_tilesets) {
+                m_hud->untrack_texture(slot->texture.get());
+            }
+        }
+    }
+
+    WorldStreamer(const WorldStreamer &) = delete;
+    WorldStreamer &operator=(const WorldStreamer &) = delete;
+
+    // Wątek gry: ładuje regiony w load_radius, zwalnia te dalej niż unload_radius (histereza)
+    void update(float camera_x, float camera_y) {
+        m_camera = {camera_x, camera_y};
+
+        for (std::size_t i = m_active.size(); i-- > 0;) {
+            const auto index = m_active[i];
+            if (distance_to(index) > m_config.unload_radius) {
+                evict(index);
+            }
+        }
+
+        const auto region_w = static_cast<float>(m_config.region_tiles * m_tile_width);
+        const auto region_h = static_cast<float>(m_config.region_tiles * m_tile_height);
+        const int min_x = std::max(0, static_cast<int>((camera_x - m_config.load_radius) / region_w));
+        const int max_x = std::min(m_regions_x - 1, static_cast<int>((camera_x + m_config.load_radius) / region_w));
+        const int min_y = std::max(0, static_cast<int>((camera_y - m_config.load_radius) / region_h));
+        const int max_y = std::min(m_regions_y - 1, static_cast<int>((camera_y + m_config.load_radius) / region_h));
+        for (int y = min_y; y <= max_y; ++y) {
+            for (int x = min_x; x <= max_x; ++x) {
+                const auto index = static_cast<std::uint32_t>(y * m_regions_x + x);
+                if (m_regions[index].state == RegionState::Unloaded && distance_to(index) <= m_config.load_radius) {
+                    request_load(index);
+                }
+            }
+        }
+    }
+
+    // Wątek renderujący: tworzy tekstury dla gotowych regionów (max_uploads_per_frame na klatkę)
+    void pump_uploads(SDL_Renderer *renderer) {
+        if (!renderer) return;
+
+        {
+            std::lock_guard lock(m_mutex);
+            std::swap(m_incoming, m_completed);
+        }
+        for (auto &loaded: m_incoming) {
+            auto &region = m_regions[loaded->region];
+            if (region.generation != loaded->generation || region.state != RegionState::Loading) {
+                // Region zwolniony w trakcie ładowania
+                release_surfaces(*loaded);
+                continue;
+            }
+            region.state = RegionState::Ready;
+            m_ready.push_back(std::move(loaded));
+        }
+        m_incoming.clear();
+
+        int uploads = 0;
+        for (auto &loaded: m_ready) {
+            if (uploads >= m_config.max_uploads_per_frame) break;
+            if (!loaded) continue;
+            auto &region = m_regions[loaded->region];
+            if (region.generation != loaded->generation) {
+                release_surfaces(*loaded);
+                loaded.reset();
+                continue;
+            }
+            if (try_upload(renderer, loaded)) {
+                ++uploads;
+            }
+        }
+        std::erase_if(m_ready, [](const auto &loaded) { return !loaded; });
+
+        m_stats.pending_regions = 0;
+        m_stats.deferred_regions = 0;
+        for (const auto &loaded: m_ready) {
+            if (m_regions[loaded->region].deferred) {
+                ++m_stats.deferred_regions;
+            } else {
+                ++m_stats.pending_regions;
+            }
+        }
+        for (const auto index: m_active) {
+            if (m_regions[index].state == RegionState::Loading) ++m_stats.pending_regions;
+        }
+        m_stats.surface_bytes = m_used_bytes.load() - m_stats.region_bytes - m_stats.texture_bytes;
+    }
+
+    // Rysuje rezydentne kafelki widoczne w view (współrzędne świata): jedno SDL_RenderGeometry
+    // na tileset w każdej warstwie. Zwraca liczbę wywołań rysowania, HUD dostaje je razem z liczbą kafelków.
+    std::uint32_t render(SDL_Renderer *renderer, const SDL_FRect &view) noexcept {
+        if (!renderer) return 0;
+
+        // Bufory rosną tylko, gdy widok obejmuje więcej kafelków niż dotąd - w steady-state bez alokacji
+        const auto visible_tiles = static_cast<std::size_t>(std::ceil(view.w / static_cast<float>(m_tile_width)) + 1) *
+                                   static_cast<std::size_t>(std::ceil(view.h / static_cast<float>(m_tile_height)) + 1);
+        for (auto &batch: m_batches) {
+            batch.vertices.reserve(visible_tiles * 4);
+            batch.indices.reserve(visible_tiles * 6);
+        }
+
+        std::uint32_t draws = 0;
+        for (std::size_t layer = 0; layer < m_tile_layers.size(); ++layer) {
+            for (const auto index: m_active) {
+                const auto &region = m_regions[index];
+                if (region.state != RegionState::Resident) continue;
+
+                const auto coord = coord_of(index);
+                const auto bounds = bounds_of(coord);
+                if (bounds.x > view.x + view.w || bounds.y > view.y + view.h ||
+                    bounds.x + bounds.w < view.x || bounds.y + bounds.h < view.y) {
+                    continue;
+                }
+
+                // Tylko kafelki regionu, które przecinają widok
+                const int w = std::min(m_config.region_tiles, m_map_width - coord.x * m_config.region_tiles);
+                const int h = std::min(m_config.region_tiles, m_map_height - coord.y * m_config.region_tiles);
+                const int tx0 = std::max(0, static_cast<int>((view.x - bounds.x) / static_cast<float>(m_tile_width)));
+                const int ty0 = std::max(0, static_cast<int>((view.y - bounds.y) / static_cast<float>(m_tile_height)));
+                const int tx1 = std::min(w, static_cast<int>(
+                                             std::ceil((view.x + view.w - bounds.x) / static_cast<float>(m_tile_width))));
+                const int ty1 = std::min(h, static_cast<int>(
+                                             std::ceil((view.y + view.h - bounds.y) / static_cast<float>(m_tile_height))));
+
+                const auto &tiles = region.data->layers[layer];
+                for (int ty = ty0; ty < ty1; ++ty) {
+                    for (int tx = tx0; tx < tx1; ++tx) {
+                        const auto gid = tiles[static_cast<std::size_t>(ty) * w + tx];
+                        if (gid == 0) continue;
+                        const auto t = tileset_of(gid);
+                        const auto &slot = *m_tilesets[t];
+                        if (!slot.texture) continue;
+
+                        const auto local = static_cast<int>(gid - slot.first_gid);
+                        const auto texture_w = static_cast<float>(slot.texture->w);
+                        const auto texture_h = static_cast<float>(slot.texture->h);
+                        const auto u0 = static_cast<float>(
+                                            slot.margin + (local % slot.columns) * (slot.tile_width + slot.spacing)) / texture_w;
+                        const auto v0 = static_cast<float>(
+                                            slot.margin + (local / slot.columns) * (slot.tile_height + slot.spacing)) / texture_h;
+                        const auto u1 = u0 + static_cast<float>(slot.tile_width) / texture_w;
+                        const auto v1 = v0 + static_cast<float>(slot.tile_height) / texture_h;
+                        const float x0 = bounds.x + static_cast<float>(tx * m_tile_width) - view.x;
+                        const float y0 = bounds.y + static_cast<float>(ty * m_tile_height) - view.y;
+                        const float x1 = x0 + static_cast<float>(slot.tile_width);
+                        const float y1 = y0 + static_cast<float>(slot.tile_height);
+
+                        auto &batch = m_batches[t];
+                        constexpr SDL_FColor white{1.0f, 1.0f, 1.0f, 1.0f};
+                        const int base = static_cast<int>(batch.vertices.size());
+                        batch.vertices.push_back({{x0, y0}, white, {u0, v0}});
+                        batch.vertices.push_back({{x1, y0}, white, {u1, v0}});
+                        batch.vertices.push_back({{x1, y1}, white, {u1, v1}});
+                        batch.vertices.push_back({{x0, y1}, white, {u0, v1}});
+                        for (const int offset: {0, 1, 2, 0, 2, 3}) {
+                            batch.indices.push_back(base + offset);
+                        }
+                    }
+                }
+            }
+
+            // Warstwa kończy się przed następną - kolejność rysowania warstw zostaje zachowana
+            for (std::size_t t = 0; t < m_batches.size(); ++t) {
+                auto &batch = m_batches[t];
+                if (batch.indices.empty()) continue;
+                SDL_RenderGeometry(renderer, m_tilesets[t]->texture.get(),
+                                   batch.vertices.data(), static_cast<int>(batch.vertices.size()),
+                                   batch.indices.data(), static_cast<int>(batch.indices.size()));
+                if (m_hud) m_hud->count_draw_call(static_cast<std::uint32_t>(batch.indices.size() / 6));
+                ++draws;
+                batch.vertices.clear();
+                batch.indices.clear();
+            }
+        }
+        return draws;
+    }
+
+    template<typename Callback>
+    void for_each_resident_entity(Callback &&callback) const {
+        for (const auto index: m_active) {
+            const auto &region = m_regions[index];
+            if (region.state != RegionState::Resident) continue;
+            for (const auto &entity: region.data->entities) {
+                callback(entity);
+            }
+        }
+    }
+
+    // Regiony rezydentne: bajty i opóźnienie ładowania. out z pojemnością region_count() nie alokuje.
+    void collect_region_stats(std::vector<RegionStats> &out) const {
+        out.clear();
+        for (const auto index: m_active) {
+            const auto &region = m_regions[index];
+            if (region.state != RegionState::Resident) continue;
+            out.push_back(RegionStats{coord_of(index), region.data->bytes, region.load_latency_ms});
+        }
+    }
+
+    [[nodiscard]] const StreamingStats &stats() const noexcept {
+        return m_stats;
+    }
+
+    [[nodiscard]] std::size_t region_count() const noexcept {
+        return m_regions.size();
+    }
+
+    [[nodiscard]] SDL_FPoint world_size() const noexcept {
+        return {static_cast<float>(m_map_width * m_tile_width), static_cast<float>(m_map_height * m_tile_height)};
+    }
+};
+
+// hud (opcjonalny) dostaje track_texture/untrack_texture dla tekstur tilesetów
+[[nodiscard]] inline auto createWorldStreamer(const std::string &map_path, const StreamingConfig &config,
+                                              PerformanceHud *hud) noexcept
+    -> std::expected<std::unique_ptr<WorldStreamer>, SDLError> {
+    try {
+        if (!std::filesystem::exists(map_path)) {
+            log_error("File does not exist: {}", map_path);
+            return std::unexpected(SDLError::MapStreamingFailed);
+        }
+        if (config.region_tiles <= 0 || config.unload_radius < config.load_radius) [[unlikely]] {
+            log_error("Invalid streaming config: region_tiles={} load={} unload={}",
+                      config.region_tiles, config.load_radius, config.unload_radius);
+            return std::unexpected(SDLError::MapStreamingFailed);
+        }
+
+        tson::Tileson tileson;
+        auto map = tileson.parse(std::filesystem::path{map_path});
+        if (!map || map->getStatus() != tson::ParseStatus::OK) [[unlikely]] {
+            log_error("Map parsing failed: {}", map ? map->getStatusMessage() : std::string{"no map"});
+            return std::unexpected(SDLError::MapStreamingFailed);
+        }
+
+        auto streamer = std::make_unique<WorldStreamer>(std::move(map),
+                                                        std::filesystem::path{map_path}.parent_path(), config, hud);
+        log_info("✅ Streaming mapy: {}", map_path);
+        return streamer;
+    } catch (...) {
+        return std::unexpected(SDLError::MapStreamingFailed);
+    }
+}
+
+#endif //SDLWORLDSTREAMING_HPP
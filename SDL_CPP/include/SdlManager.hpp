@@ -5,29 +5,38 @@
 #ifndef SDLMANAGER_HPP
 #define SDLMANAGER_HPP
 #include <SDL3/SDL.h>
-#include <iostream>
 #include <utility>
 
+#include "SDLLogger.hpp"
+
 
 // POPRAWIONY RAII wrapper dla SDL
 class SDL_Manager {
 private:
     bool m_initialized{false};
+    bool m_audio_initialized{false};
 
 public:
     SDL_Manager() noexcept {
         // POPRAWKA: SDL_Init zwraca bool (true = sukces)
         m_initialized = SDL_Init(SDL_INIT_VIDEO);
         if (m_initialized) {
-            std::cout << "🔧 SDL zainicjalizowane: " << SDL_GetRevision() << "\n";
+            log_info("🔧 SDL zainicjalizowane: {}", SDL_GetRevision());
         } else {
-            std::cerr << "❌ SDL Init failed: " << SDL_GetError() << "\n";
+            log_error("❌ SDL Init failed: {}", SDL_GetError());
+            return;
+        }
+
+        // Brak audio nie blokuje gry - sprawdzane przez audio_initialized()
+        m_audio_initialized = SDL_InitSubSystem(SDL_INIT_AUDIO);
+        if (!m_audio_initialized) {
+            log_warn("⚠️  SDL audio init failed: {}", SDL_GetError());
         }
     }
 
     ~SDL_Manager() noexcept {
         if (m_initialized) [[likely]] {
-            std::cout << "🧹 Sprzątanie SDL...\n";
+            log_info("🧹 Sprzątanie SDL...");
             SDL_Quit();
         }
     }
@@ -40,9 +49,14 @@ public:
         return m_initialized;
     }
 
+    [[nodiscard]] constexpr bool audio_initialized() const noexcept {
+        return m_audio_initialized;
+    }
+
     // C++20 Move semantics
     SDL_Manager(SDL_Manager&& other) noexcept
-        : m_initialized(std::exchange(other.m_initialized, false)) {}
+        : m_initialized(std::exchange(other.m_initialized, false)),
+          m_audio_initialized(std::exchange(other.m_audio_initialized, false)) {}
 
     SDL_Manager& operator=(SDL_Manager&& other) noexcept {
         if (this != &other) {
@@ -50,6 +64,7 @@ public:
                 SDL_Quit();
             }
             m_initialized = std::exchange(other.m_initialized, false);
+            m_audio_initialized = std::exchange(other.m_audio_initialized, false);
         }
         return *this;
     }
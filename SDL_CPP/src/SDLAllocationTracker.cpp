@@ -0,0 +1,256 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#include "../include/SDLAllocationTracker.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <SDL3/SDL.h>
+
+#include "../include/SDLLogger.hpp"
+#include "../include/SDLPerformanceHud.hpp"
+
+namespace {
+    struct AtomicStats {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> bytes{0};
+        std::atomic<std::uint64_t> frees{0};
+    };
+
+    std::array<AtomicStats, AllocationTracker::max_scopes> g_frame_scopes{};
+    AllocationTracker::ScopeStats g_last_frame_scopes{};
+    AtomicStats g_total{};
+
+    std::atomic<bool> g_strict_enabled{false};
+    std::atomic<bool> g_strict_active{false};
+    std::atomic<std::uint64_t> g_violations{0};
+    std::atomic<std::size_t> g_first_violation_bytes{0};
+    std::atomic<std::uint8_t> g_first_violation_scope{AllocationTracker::no_scope};
+    AllocationPolicy g_policy{AllocationPolicy::Report};
+    std::uint64_t g_warmup_frames{0};
+    std::uint64_t g_frame_index{0};
+
+    thread_local std::uint8_t t_scope{AllocationTracker::no_scope};
+    thread_local bool t_frame_thread{false};
+    // Chroni przed liczeniem alokacji samego raportowania
+    thread_local bool t_reentrant{false};
+
+    SDL_malloc_func g_sdl_malloc{nullptr};
+    SDL_calloc_func g_sdl_calloc{nullptr};
+    SDL_realloc_func g_sdl_realloc{nullptr};
+    SDL_free_func g_sdl_free{nullptr};
+
+    const char *scope_name(std::uint8_t scope) noexcept {
+        if (scope < frame_phase_count) {
+            return get_phase_name(static_cast<FramePhase>(scope)).data();
+        }
+        return "none";
+    }
+
+    void *tracked_sdl_malloc(size_t size) {
+        AllocationTracker::record_allocation(size);
+        return g_sdl_malloc(size);
+    }
+
+    void *tracked_sdl_calloc(size_t nmemb, size_t size) {
+        AllocationTracker::record_allocation(nmemb * size);
+        return g_sdl_calloc(nmemb, size);
+    }
+
+    void *tracked_sdl_realloc(void *mem, size_t size) {
+        AllocationTracker::record_allocation(size);
+        return g_sdl_realloc(mem, size);
+    }
+
+    void tracked_sdl_free(void *mem) {
+        if (mem) AllocationTracker::record_free();
+        g_sdl_free(mem);
+    }
+} // namespace
+
+void AllocationTracker::install_sdl_hooks() noexcept {
+    if constexpr (!enabled()) {
+        return;
+    }
+    SDL_GetOriginalMemoryFunctions(&g_sdl_malloc, &g_sdl_calloc, &g_sdl_realloc, &g_sdl_free);
+    if (!SDL_SetMemoryFunctions(tracked_sdl_malloc, tracked_sdl_calloc, tracked_sdl_realloc, tracked_sdl_free)) {
+        log_error("❌ SDL_SetMemoryFunctions() failed: {}", SDL_GetError());
+    }
+}
+
+void AllocationTracker::begin_frame(bool steady_state) noexcept {
+    t_frame_thread = true;
+
+    for (std::size_t scope = 0; scope < max_scopes; ++scope) {
+        auto &stats = g_frame_scopes[scope];
+        g_last_frame_scopes[scope] = AllocationStats{
+            .count = stats.count.exchange(0, std::memory_order_relaxed),
+            .bytes = stats.bytes.exchange(0, std::memory_order_relaxed),
+            .frees = stats.frees.exchange(0, std::memory_order_relaxed),
+        };
+    }
+
+    // Raport z poprzedniej klatki - poza hookiem, formatowanie odbywa się na wątku loggera
+    if (const auto bytes = g_first_violation_bytes.exchange(0, std::memory_order_relaxed); bytes != 0) {
+        t_reentrant = true;
+        log_warn("⚠️  Alokacja w klatce steady-state {}: {} B (scope: {})",
+                 g_frame_index, bytes, scope_name(g_first_violation_scope.load(std::memory_order_relaxed)));
+        t_reentrant = false;
+    }
+
+    ++g_frame_index;
+    g_strict_active.store(g_strict_enabled.load(std::memory_order_relaxed) &&
+                          steady_state && g_frame_index > g_warmup_frames,
+                          std::memory_order_relaxed);
+}
+
+void AllocationTracker::enable_strict_mode(std::uint64_t warmup_frames, AllocationPolicy policy) noexcept {
+    g_warmup_frames = g_frame_index + warmup_frames;
+    g_policy = policy;
+    g_strict_enabled.store(true, std::memory_order_relaxed);
+}
+
+void AllocationTracker::disable_strict_mode() noexcept {
+    g_strict_enabled.store(false, std::memory_order_relaxed);
+    g_strict_active.store(false, std::memory_order_relaxed);
+}
+
+AllocationStats AllocationTracker::last_frame() noexcept {
+    AllocationStats result{};
+    for (const auto &stats: g_last_frame_scopes) {
+        result.count += stats.count;
+        result.bytes += stats.bytes;
+        result.frees += stats.frees;
+    }
+    return result;
+}
+
+AllocationTracker::ScopeStats AllocationTracker::last_frame_scopes() noexcept {
+    return g_last_frame_scopes;
+}
+
+AllocationStats AllocationTracker::total() noexcept {
+    return AllocationStats{
+        .count = g_total.count.load(std::memory_order_relaxed),
+        .bytes = g_total.bytes.load(std::memory_order_relaxed),
+        .frees = g_total.frees.load(std::memory_order_relaxed),
+    };
+}
+
+std::uint64_t AllocationTracker::steady_state_violations() noexcept {
+    return g_violations.load(std::memory_order_relaxed);
+}
+
+auto AllocationTracker::verify_steady_state() noexcept -> std::expected<void, SDLError> {
+    if (steady_state_violations() != 0) {
+        return std::unexpected(SDLError::SteadyStateAllocation);
+    }
+    return {};
+}
+
+void AllocationTracker::record_allocation(std::size_t bytes) noexcept {
+    if (t_reentrant) [[unlikely]] {
+        return;
+    }
+
+    auto &stats = g_frame_scopes[t_scope];
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    g_total.count.fetch_add(1, std::memory_order_relaxed);
+    g_total.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    // Wątki w tle (ładowanie, logi) mogą alokować - ścisły tryb dotyczy tylko wątku pętli gry
+    if (t_frame_thread && g_strict_active.load(std::memory_order_relaxed)) [[unlikely]] {
+        g_violations.fetch_add(1, std::memory_order_relaxed);
+        if (g_policy == AllocationPolicy::Abort) {
+            // Synchronicznie - proces zaraz się kończy, kolejka loggera nie zostanie opróżniona
+            t_reentrant = true;
+            std::fprintf(stderr, "❌ Alokacja %zu B w klatce steady-state (scope: %s)\n", bytes, scope_name(t_scope));
+            std::abort();
+        }
+        std::size_t expected{0};
+        if (g_first_violation_bytes.compare_exchange_strong(expected, bytes, std::memory_order_relaxed)) {
+            g_first_violation_scope.store(t_scope, std::memory_order_relaxed);
+        }
+    }
+}
+
+void AllocationTracker::record_free() noexcept {
+    if (t_reentrant) [[unlikely]] {
+        return;
+    }
+    g_frame_scopes[t_scope].frees.fetch_add(1, std::memory_order_relaxed);
+    g_total.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint8_t AllocationTracker::exchange_scope(std::uint8_t scope) noexcept {
+    const auto previous = t_scope;
+    t_scope = scope < max_scopes ? scope : no_scope;
+    return previous;
+}
+
+#ifdef DRUGSWAR_TRACK_ALLOCATIONS
+namespace {
+    void *tracked_new(std::size_t size) {
+        AllocationTracker::record_allocation(size);
+        if (void *ptr = std::malloc(size ? size : 1)) {
+            return ptr;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void *tracked_new_aligned(std::size_t size, std::align_val_t alignment) {
+        AllocationTracker::record_allocation(size);
+        const auto align = static_cast<std::size_t>(alignment);
+        // aligned_alloc wymaga rozmiaru będącego wielokrotnością wyrównania
+        const std::size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+        if (void *ptr = std::aligned_alloc(align, rounded)) {
+            return ptr;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void tracked_delete(void *ptr) noexcept {
+        if (!ptr) return;
+        AllocationTracker::record_free();
+        std::free(ptr);
+    }
+} // namespace
+
+void *operator new(std::size_t size) { return tracked_new(size); }
+void *operator new[](std::size_t size) { return tracked_new(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return tracked_new_aligned(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return tracked_new_aligned(size, alignment); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try { return tracked_new(size); } catch (...) { return nullptr; }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    try { return tracked_new(size); } catch (...) { return nullptr; }
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try { return tracked_new_aligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try { return tracked_new_aligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+void operator delete(void *ptr) noexcept { tracked_delete(ptr); }
+void operator delete[](void *ptr) noexcept { tracked_delete(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { tracked_delete(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { tracked_delete(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { tracked_delete(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { tracked_delete(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { tracked_delete(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { tracked_delete(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { tracked_delete(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { tracked_delete(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { tracked_delete(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { tracked_delete(ptr); }
+#endif
@@ -0,0 +1,225 @@
+//
+// Created by mic on 19.10.26.
+//
+
+#include "../include/SDLLogger.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include <SDL3/SDL.h>
+
+#include "../include/SDLSpscRingBuffer.hpp"
+
+namespace {
+    constexpr std::size_t thread_ring_capacity{512};
+
+    struct ThreadQueue {
+        SpscRingBuffer<logging::LogRecord, thread_ring_capacity> ring{};
+        std::uint32_t thread_id{0};
+        // false po zakończeniu wątku-właściciela - opróżniony ring przejmuje kolejny wątek
+        std::atomic<bool> owned{true};
+    };
+
+    // Zwalnia ring przy końcu wątku. Id wątku w logach to numer ringu, więc też jest odzyskiwane.
+    struct QueueLease {
+        ThreadQueue *queue{nullptr};
+
+        ~QueueLease() {
+            if (queue) {
+                queue->owned.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    struct LoggerState {
+        std::mutex mutex{};
+        std::condition_variable_any wake{};
+        // Ringi żyją do końca programu - wątek może się zakończyć z nieopróżnionym ringiem.
+        // Liczba ringów = maksymalna liczba jednocześnie logujących wątków.
+        std::vector<std::unique_ptr<ThreadQueue> > queues{};
+        std::jthread flusher{};
+        std::FILE *file{nullptr};
+        bool console{true};
+        std::chrono::milliseconds flush_interval{5};
+        std::uint64_t start_ns{0};
+    };
+
+    LoggerState &state() {
+        static LoggerState instance{};
+        return instance;
+    }
+
+    std::atomic<std::uint64_t> g_dropped{0};
+    thread_local QueueLease t_lease{};
+
+    ThreadQueue *register_thread() {
+        auto &logger = state();
+        std::lock_guard lock(logger.mutex);
+        // Najpierw ring po zakończonym wątku, już opróżniony przez wątek loggera
+        for (const auto &queue: logger.queues) {
+            if (queue->ring.size() != 0) continue;
+            bool expected = false;
+            if (queue->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return queue.get();
+            }
+        }
+        auto queue = std::make_unique<ThreadQueue>();
+        queue->thread_id = static_cast<std::uint32_t>(logger.queues.size());
+        return logger.queues.emplace_back(std::move(queue)).get();
+    }
+
+    LogLevel from_sdl_priority(SDL_LogPriority priority) noexcept {
+        switch (priority) {
+            case SDL_LOG_PRIORITY_TRACE:
+            case SDL_LOG_PRIORITY_VERBOSE: return LogLevel::Trace;
+            case SDL_LOG_PRIORITY_DEBUG: return LogLevel::Debug;
+            case SDL_LOG_PRIORITY_INFO: return LogLevel::Info;
+            case SDL_LOG_PRIORITY_WARN: return LogLevel::Warn;
+            case SDL_LOG_PRIORITY_ERROR: return LogLevel::Error;
+            case SDL_LOG_PRIORITY_CRITICAL: return LogLevel::Critical;
+            default: return LogLevel::Info;
+        }
+    }
+
+    void SDLCALL sdl_log_output([[maybe_unused]] void *userdata, int category,
+                                SDL_LogPriority priority, const char *message) {
+        Logger::log(from_sdl_priority(priority), "SDL[{}]: {}", category, message);
+    }
+
+    void write_line(LoggerState &logger, LogLevel level, const std::string &line) {
+        if (logger.console) {
+            std::FILE *stream = level >= LogLevel::Warn ? stderr : stdout;
+            std::fwrite(line.data(), 1, line.size(), stream);
+        }
+        if (logger.file) {
+            std::fwrite(line.data(), 1, line.size(), logger.file);
+        }
+    }
+
+    // Formatowanie i zapis - tylko na wątku loggera
+    bool drain(LoggerState &logger, std::vector<ThreadQueue *> &queues, std::string &line) {
+        {
+            std::lock_guard lock(logger.mutex);
+            queues.clear();
+            for (const auto &queue: logger.queues) {
+                queues.push_back(queue.get());
+            }
+        }
+
+        bool wrote = false;
+        for (auto *queue: queues) {
+            while (const auto record = queue->ring.try_pop()) {
+                line.clear();
+                const auto elapsed_ns = record->timestamp_ns - std::min(record->timestamp_ns, logger.start_ns);
+                std::format_to(std::back_inserter(line), "[{:10.3f}] {} #{} ",
+                               static_cast<double>(elapsed_ns) / 1e9,
+                               get_log_level_name(record->level), record->thread_id);
+                try {
+                    record->format_fn(line, record->fmt, record->args.data());
+                } catch (...) {
+                    line.append("<format error: ").append(record->fmt).append(">");
+                }
+                line.push_back('\n');
+                write_line(logger, record->level, line);
+                wrote = true;
+            }
+        }
+        return wrote;
+    }
+
+    void flush_loop(const std::stop_token &stop_token) {
+        auto &logger = state();
+        std::vector<ThreadQueue *> queues{};
+        std::string line{};
+        std::uint64_t reported_drops{0};
+
+        while (!stop_token.stop_requested()) {
+            const bool wrote = drain(logger, queues, line);
+
+            if (const auto drops = g_dropped.load(std::memory_order_relaxed); drops != reported_drops) {
+                line = std::format("[logger] odrzucono {} rekordów (pełny ring)\n", drops - reported_drops);
+                write_line(logger, LogLevel::Warn, line);
+                reported_drops = drops;
+            }
+
+            if (wrote) {
+                if (logger.console) std::fflush(stdout);
+                if (logger.file) std::fflush(logger.file);
+            }
+
+            std::unique_lock lock(logger.mutex);
+            logger.wake.wait_for(lock, stop_token, logger.flush_interval, [] { return false; });
+        }
+
+        drain(logger, queues, line);
+    }
+} // namespace
+
+void Logger::start(const LoggerConfig &config) {
+    auto &logger = state();
+    if (logger.flusher.joinable()) {
+        return;
+    }
+
+    logger.console = config.console;
+    logger.flush_interval = config.flush_interval;
+    logger.start_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    if (config.file_path) {
+        logger.file = std::fopen(config.file_path->c_str(), "w");
+        if (!logger.file) {
+            std::fprintf(stderr, "❌ Nie można otworzyć pliku logu %s\n", config.file_path->c_str());
+        }
+    }
+
+    logger.flusher = std::jthread(flush_loop);
+    SDL_SetLogOutputFunction(sdl_log_output, nullptr);
+}
+
+void Logger::stop() noexcept {
+    auto &logger = state();
+    if (!logger.flusher.joinable()) {
+        return;
+    }
+
+    SDL_SetLogOutputFunction(SDL_GetDefaultLogOutputFunction(), nullptr);
+    logger.flusher.request_stop();
+    logger.flusher.join();
+
+    std::fflush(stdout);
+    if (logger.file) {
+        std::fclose(logger.file);
+        logger.file = nullptr;
+    }
+}
+
+bool Logger::push(const logging::LogRecord &record) noexcept {
+    if (!t_lease.queue) [[unlikely]] {
+        // Pierwszy log z danego wątku - jedyna możliwa alokacja w ścieżce logowania
+        try {
+            t_lease.queue = register_thread();
+        } catch (...) {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    logging::LogRecord stamped = record;
+    stamped.thread_id = t_lease.queue->thread_id;
+    if (!t_lease.queue->ring.try_push(stamped)) [[unlikely]] {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t Logger::dropped() noexcept {
+    return g_dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,157 @@
+//
+// Created by mic on 19.10.26.
+//
+
+// Benchmark: jedno pole przepływu + próbkowanie O(1) kontra A* per agent przy 100, 1k i 10k agentów.
+// Dodatkowo przyrostowa naprawa pola po zmianie siatki kontra pełne przeliczenie - naprawione pole
+// musi być identyczne z policzonym od zera, inaczej benchmark kończy się błędem.
+
+#include <SDL3/SDL.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../SDL_CPP/include/SDLArgumentsStructure.hpp"
+#include "../SDL_CPP/include/SDLLogger.hpp"
+#include "../SDL_CPP/include/SDLPathfinding.hpp"
+
+namespace {
+    constexpr int grid_size{128};
+    constexpr float cell_size{16.0f};
+    constexpr std::uint32_t wall_percent{22};
+    constexpr std::array<std::size_t, 3> agent_counts{100, 1000, 10000};
+    constexpr std::size_t repair_rounds{200};
+    constexpr GridCell goal{grid_size / 2, grid_size / 2};
+
+    using Clock = std::chrono::steady_clock;
+
+    double elapsed_ms(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    NavigationGrid make_grid(std::mt19937 &random) {
+        NavigationGrid grid(grid_size, grid_size, cell_size, cell_size);
+        for (int y = 0; y < grid_size; ++y) {
+            for (int x = 0; x < grid_size; ++x) {
+                if (random() % 100 < wall_percent) grid.set_blocked({x, y}, true);
+            }
+        }
+        grid.set_blocked(goal, false);
+        return grid;
+    }
+
+    std::vector<GridCell> make_agents(const FlowField &field, std::mt19937 &random, std::size_t count) {
+        std::vector<GridCell> agents{};
+        agents.reserve(count);
+        while (agents.size() < count) {
+            const GridCell cell{static_cast<int>(random() % grid_size), static_cast<int>(random() % grid_size)};
+            if (field.reachable(cell)) agents.push_back(cell);
+        }
+        return agents;
+    }
+
+    bool same_field(const FlowField &a, const FlowField &b) {
+        for (int y = 0; y < grid_size; ++y) {
+            for (int x = 0; x < grid_size; ++x) {
+                const auto da = a.direction_at({x, y});
+                const auto db = b.direction_at({x, y});
+                if (a.integration_at({x, y}) != b.integration_at({x, y}) || da.x != db.x || da.y != db.y) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void compare_agents(const NavigationGrid &grid, std::mt19937 &random) {
+        const FlowField reference(grid, goal, 1);
+        AStarPathfinder astar{};
+        std::vector<GridCell> path{};
+
+        for (const auto count: agent_counts) {
+            const auto agents = make_agents(reference, random, count);
+
+            // Pole przepływu: jedno przeliczenie + próbka na agenta
+            auto start = Clock::now();
+            const FlowField field(grid, goal, 1);
+            const double build_ms = elapsed_ms(start);
+            start = Clock::now();
+            float checksum = 0;
+            for (const auto agent: agents) {
+                const auto center = grid.cell_center(agent);
+                const auto direction = field.sample(center.x, center.y);
+                checksum += direction.x + direction.y;
+            }
+            const double sample_ms = elapsed_ms(start);
+
+            // A*: pełne wyszukiwanie na agenta
+            start = Clock::now();
+            std::size_t path_cells = 0;
+            for (const auto agent: agents) {
+                if (astar.find_path(grid, agent, goal, path)) path_cells += path.size();
+            }
+            const double astar_ms = elapsed_ms(start);
+
+            const double flow_ms = build_ms + sample_ms;
+            log_info("{:>5} agentów | flow field {:.3f} ms (build {:.3f} + sample {:.4f}) | A* {:.3f} ms | x{:.1f} [{} {}]",
+                     count, flow_ms, build_ms, sample_ms, astar_ms, astar_ms / flow_ms, checksum, path_cells);
+        }
+    }
+
+    // false gdy naprawione pole różni się od pełnego przeliczenia
+    bool compare_repair(NavigationGrid grid, std::mt19937 &random) {
+        auto field = std::make_unique<FlowField>(grid, goal, 1);
+        std::vector<std::uint32_t> changed{};
+        double repair_total_ms = 0;
+        double full_total_ms = 0;
+        std::size_t changed_total = 0;
+
+        for (std::size_t round = 0; round < repair_rounds; ++round) {
+            // Przełączenie bloku 3x3 (drzwi, zawalony korytarz) poza celem
+            NavigationGrid next = grid;
+            const int bx = static_cast<int>(random() % (grid_size - 3));
+            const int by = static_cast<int>(random() % (grid_size - 3));
+            const bool block = random() % 2 == 0;
+            for (int y = by; y < by + 3; ++y) {
+                for (int x = bx; x < bx + 3; ++x) {
+                    if (GridCell{x, y} != goal) next.set_blocked({x, y}, block);
+                }
+            }
+            grid.changed_cells(next, changed);
+            changed_total += changed.size();
+            const auto version = static_cast<std::uint64_t>(round + 2);
+
+            auto start = Clock::now();
+            auto repaired = std::make_unique<FlowField>(*field, next, changed, version);
+            repair_total_ms += elapsed_ms(start);
+
+            start = Clock::now();
+            const FlowField full(next, goal, version);
+            full_total_ms += elapsed_ms(start);
+
+            if (!same_field(*repaired, full)) {
+                log_error("❌ Runda {}: naprawione pole różni się od pełnego przeliczenia", round);
+                return false;
+            }
+            field = std::move(repaired);
+            grid = std::move(next);
+        }
+
+        log_info("naprawa przyrostowa: {} rund, {} zmienionych komórek | repair {:.4f} ms/rundę, full {:.4f} ms/rundę",
+                 repair_rounds, changed_total, repair_total_ms / repair_rounds, full_total_ms / repair_rounds);
+        return true;
+    }
+} // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+    LoggerGuard logger_guard(LoggerConfig{});
+
+    std::mt19937 random{20251019};
+    const auto grid = make_grid(random);
+    log_info("siatka {}x{}, {}% ścian, cel ({}, {})", grid_size, grid_size, wall_percent, goal.x, goal.y);
+
+    compare_agents(grid, random);
+    return compare_repair(grid, random) ? 0 : 1;
+}
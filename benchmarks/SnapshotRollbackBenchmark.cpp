@@ -0,0 +1,129 @@
+//
+// Created by mic on 19.10.26.
+//
+
+// Benchmark rollbacku: restore migawki sprzed rollback_frames klatek + ponowna symulacja
+// zapisanych wejść. Najgorszy przypadek musi zmieścić się w budżecie jednej klatki (60 FPS),
+// a restore + ponowna symulacja nie mogą alokować (klatka steady-state w trybie ścisłym).
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../SDL_CPP/include/SDLAllocationTracker.hpp"
+#include "../SDL_CPP/include/SDLArgumentsStructure.hpp"
+#include "../SDL_CPP/include/SDLGameEngineStructures.hpp"
+#include "../SDL_CPP/include/SDLLogger.hpp"
+#include "../SDL_CPP/include/SDLWorldSnapshot.hpp"
+
+namespace {
+    constexpr double frame_budget_ms{1000.0 / 60.0};
+    constexpr std::size_t iterations{20000};
+
+    FrameInput input_for(std::uint64_t frame) noexcept {
+        // Deterministyczny wzór wejść: lewo, prawo, puszczone
+        return FrameInput{
+            .delta_time = 1.0f / 60.0f,
+            .left = frame % 3 == 0,
+            .right = frame % 3 == 1,
+        };
+    }
+
+    SimulationWorld make_world() noexcept {
+        SimulationWorld world{};
+        world.entity_count = SimulationWorld::max_entities;
+        for (std::size_t i = 0; i < SimulationWorld::max_entities; ++i) {
+            world.position_x[i] = static_cast<float>(i);
+            world.position_y[i] = static_cast<float>(i * 2);
+        }
+        return world;
+    }
+
+    // false gdy rollback nie odtworzył stanu, przekroczył budżet albo alokował
+    bool run(SnapshotEncoding encoding, const char *name) {
+        WorldSnapshotRing<SimulationWorld, snapshot_depth> snapshots{encoding};
+        std::array<FrameInput, snapshot_depth> inputs{};
+        SimulationWorld world = make_world();
+        snapshots.save(world);
+
+        std::vector<double> samples_ms{};
+        samples_ms.reserve(iterations);
+        bool deterministic = true;
+        const auto violations_before = AllocationTracker::steady_state_violations();
+        AllocationTracker::enable_strict_mode(0, AllocationPolicy::Report);
+
+        for (std::size_t i = 0; i < iterations + snapshot_depth; ++i) {
+            // Zwykła klatka gry
+            const auto input = input_for(world.frame + 1);
+            step_world(world, input);
+            inputs[world.frame % inputs.size()] = input;
+            snapshots.save(world);
+
+            if (snapshots.size() < snapshot_depth) {
+                continue;
+            }
+
+            // Rollback: ta sama logika co GameLoop::rollback(), jako osobna klatka steady-state
+            const SimulationWorld expected = world;
+            AllocationTracker::begin_frame(true);
+            const auto start = std::chrono::steady_clock::now();
+            const auto target_frame = world.frame;
+            if (!snapshots.restore(rollback_frames, world)) {
+                AllocationTracker::disable_strict_mode();
+                log_error("❌ {}: restore({}) failed", name, rollback_frames);
+                return false;
+            }
+            while (world.frame < target_frame) {
+                step_world(world, inputs[(world.frame + 1) % inputs.size()]);
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            AllocationTracker::begin_frame(false);
+            samples_ms.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+            deterministic = deterministic && world == expected;
+        }
+
+        AllocationTracker::disable_strict_mode();
+        const auto allocations = AllocationTracker::steady_state_violations() - violations_before;
+
+        std::ranges::sort(samples_ms);
+        const double median = samples_ms[samples_ms.size() / 2];
+        const double p99 = samples_ms[samples_ms.size() * 99 / 100];
+        const double worst = samples_ms.back();
+        log_info("{}: rollback {} klatek, {} próbek, stored {} B | median {:.4f} ms, p99 {:.4f} ms, max {:.4f} ms (budżet {:.2f} ms)",
+                 name, rollback_frames, samples_ms.size(), snapshots.stored_bytes(), median, p99, worst, frame_budget_ms);
+
+        if (!deterministic) {
+            log_error("❌ {}: ponowna symulacja nie odtworzyła stanu", name);
+            return false;
+        }
+        if (allocations != 0) {
+            log_error("❌ {}: {} alokacji w restore + ponownej symulacji", name, allocations);
+            return false;
+        }
+        if (worst > frame_budget_ms) {
+            log_error("❌ {}: najgorszy rollback {:.4f} ms > budżet {:.2f} ms", name, worst, frame_budget_ms);
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+    LoggerGuard logger_guard(LoggerConfig{});
+
+    const bool full_ok = run(SnapshotEncoding::Full, "full");
+    const bool delta_ok = run(SnapshotEncoding::Delta, "delta");
+
+    // Każda alokacja w klatce steady-state kończy benchmark błędem
+    if (const auto steady = AllocationTracker::verify_steady_state(); !steady) {
+        log_error("❌ {}: {} alokacji w steady-state", error_to_string(steady.error()),
+                  AllocationTracker::steady_state_violations());
+        return 1;
+    }
+    return full_ok && delta_ok ? 0 : 1;
+}
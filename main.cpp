@@ -6,11 +6,11 @@
 #include <SDL3/SDL_main.h>
 #include <SDL3_image/SDL_image.h>
 #include <memory>
-#include <iostream>
 #include <expected>
 #include <string>
 #include <string_view>
 #include <concepts>
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <format>
@@ -28,6 +28,12 @@
 #include "./SDL_CPP/include/SDLUtilityFunctions.hpp"
 #include "./SDL_CPP/include/SDLResourcesConcepts.hpp"
 #include "./SDL_CPP/include/SDLGameEngineStructures.hpp"
+#include "./SDL_CPP/include/SDLPerformanceHud.hpp"
+#include "./SDL_CPP/include/SDLAllocationTracker.hpp"
+#include "./SDL_CPP/include/SDLAudio.hpp"
+#include "./SDL_CPP/include/SDLWorldSnapshot.hpp"
+#include "./SDL_CPP/include/SDLWorldStreaming.hpp"
+#include "./SDL_CPP/include/SDLLogger.hpp"
 
 namespace SDL_App {
     class SDLInitializer {
@@ -70,8 +76,8 @@ namespace SDL_App {
             m_sdl_state->renderer = std::move(renderer_result.value());
             m_initialized = true;
 
-            std::cout << "✅ SDL3 zainicjalizowane pomyślnie\n";
-            std::cout << "✅ Okno i renderer utworzone\n";
+            log_info("✅ SDL3 zainicjalizowane pomyślnie");
+            log_info("✅ Okno i renderer utworzone");
 
             return {};
         }
@@ -93,17 +99,65 @@ namespace SDL_App {
         float m_delta_time{0};
         Uint64 m_last_frame_time{0};
         const bool *m_keys;
-        float m_player_x{150};
         float m_floor{0};
         const float m_sprite_size{32};
-        float m_move_amount{0};
-        bool m_flip_horizontal{false};
+        SimulationWorld m_world{};
+        // Bieżąca klatka + rollback_frames wstecz, wejścia indeksowane numerem klatki
+        WorldSnapshotRing<SimulationWorld, snapshot_depth> m_snapshots{SnapshotEncoding::Delta};
+        std::array<FrameInput, decltype(m_snapshots)::depth()> m_inputs{};
+        PerformanceHud m_hud{};
+        std::unique_ptr<AudioSystem> m_audio{};
+        std::unique_ptr<WorldStreamer> m_world_streamer{};
+        // Widok w współrzędnych świata - ten sam dla streamingu i rysowania
+        SDL_FRect m_camera{};
+        static constexpr Uint64 streaming_report_interval_ms{5000};
+        Uint64 m_next_streaming_report{0};
+        std::vector<RegionStats> m_region_stats{};
+
+        // Kamera wyśrodkowana na graczu, przycięta do granic świata.
+        // Bez mapy świat to sam ekran logiczny - kamera stoi w {0, 0}, jak przed streamingiem.
+        void follow_player() noexcept {
+            m_camera.w = static_cast<float>(m_sdl_state->logW);
+            m_camera.h = static_cast<float>(m_sdl_state->logH);
+            const auto world = m_world_streamer ? m_world_streamer->world_size() : SDL_FPoint{m_camera.w, m_camera.h};
+            m_camera.x = std::clamp(m_world.position_x[0] + m_sprite_size * 0.5f - m_camera.w * 0.5f,
+                                    0.0f, std::max(0.0f, world.x - m_camera.w));
+            m_camera.y = std::clamp(m_world.position_y[0] + m_sprite_size * 0.5f - m_camera.h * 0.5f,
+                                    0.0f, std::max(0.0f, world.y - m_camera.h));
+            if (m_world_streamer) {
+                m_world_streamer->update(m_camera.x + m_camera.w * 0.5f, m_camera.y + m_camera.h * 0.5f);
+            }
+        }
+
+        // Co streaming_report_interval_ms: suma pamięci streamingu i każdy region rezydentny
+        void report_streaming() noexcept {
+            const Uint64 now = SDL_GetTicks();
+            if (!m_world_streamer || now < m_next_streaming_report) {
+                return;
+            }
+            m_next_streaming_report = now + streaming_report_interval_ms;
+
+            const auto &stats = m_world_streamer->stats();
+            log_info("🗺️  Streaming: {} regionów ({} w drodze, {} wstrzymanych) | regiony {} B, tekstury {} B, "
+                     "powierzchnie {} B | ewikcje {}, wstrzymania {} | ładowanie {:.2f} ms (max {:.2f} ms)",
+                     stats.resident_regions, stats.pending_regions, stats.deferred_regions, stats.region_bytes,
+                     stats.texture_bytes, stats.surface_bytes, stats.evictions, stats.deferred_by_cap,
+                     stats.last_load_latency_ms, stats.max_load_latency_ms);
+            // Bufor zarezerwowany na wszystkie regiony - bez alokacji
+            m_world_streamer->collect_region_stats(m_region_stats);
+            for (const auto &region: m_region_stats) {
+                log_debug("   region ({}, {}): {} B, ładowanie {:.2f} ms",
+                          region.coord.x, region.coord.y, region.resident_bytes, region.load_latency_ms);
+            }
+        }
 
     public:
 
     public:
         explicit GameLoop(std::shared_ptr<SDLState> sdl_state) noexcept
             : m_sdl_state((sdl_state)) {
+            m_world.entity_count = 1;
+            m_world.position_x[0] = 150;
         }
 
         [[nodiscard]] auto initialize_resources() -> std::expected<void, SDLError> {
@@ -119,6 +173,7 @@ namespace SDL_App {
 
             m_idle_texture = std::move(idle_texture_result.value());
             SDL_SetTextureScaleMode(m_idle_texture.get(), SDL_SCALEMODE_NEAREST);
+            m_hud.track_texture(m_idle_texture.get());
 
             // Setup logical presentation
             int result = SDL_SetRenderLogicalPresentation(
@@ -129,18 +184,39 @@ namespace SDL_App {
             );
 
             if (!result) {
-                std::cerr << "❌ SDL_SetRenderLogicalPresentation() failed: " << SDL_GetError() << "\n";
+                log_error("❌ SDL_SetRenderLogicalPresentation() failed: {}", SDL_GetError());
                 return std::unexpected(SDLError::RendererCreationFailed);
             }
 
-            std::cout << "✅ SDL_SetRenderLogicalPresentation() ok\n";
-            std::cout << std::format("Logical size: {}x{}\n",
-                                     m_sdl_state->width,
-                                     m_sdl_state->height);
+            log_info("✅ SDL_SetRenderLogicalPresentation() ok");
+            log_info("Logical size: {}x{}", m_sdl_state->width, m_sdl_state->height);
+
+            // Audio jest opcjonalne - gra działa dalej bez dźwięku
+            auto audio_result = createAudioSystem(AudioConfig{});
+            if (audio_result) {
+                m_audio = std::move(audio_result.value());
+            } else {
+                log_warn("⚠️  {}", error_to_string(audio_result.error()));
+            }
+
+            // Mapa świata jest opcjonalna - bez niej scena to sam gracz
+            if (std::filesystem::exists(world_map_path)) {
+                auto streamer_result = createWorldStreamer(world_map_path, StreamingConfig{}, &m_hud);
+                if (streamer_result) {
+                    m_world_streamer = std::move(streamer_result.value());
+                    m_region_stats.reserve(m_world_streamer->region_count());
+                } else {
+                    log_warn("⚠️  {}", error_to_string(streamer_result.error()));
+                }
+            }
 
             m_keys = SDL_GetKeyboardState(nullptr);
             m_floor = m_sdl_state->logH;
-            // Warm up cache
+            m_world.position_y[0] = m_floor - m_sprite_size;
+            m_snapshots.save(m_world);
+            follow_player();
+            // Warm up cache - HUD przed czyszczeniem, żeby rozgrzewka nie trafiła na ekran
+            m_hud.warm_up(m_sdl_state->renderer.get());
             warm_up_cache(m_sdl_state->renderer.get());
 
             return {};
@@ -155,17 +231,22 @@ namespace SDL_App {
         }
 
         void process_events() noexcept {
+            ScopedPhaseTimer phase_timer(m_hud, FramePhase::Events);
             SDL_Event event{0};
             while (SDL_PollEvent(&event)) {
                 switch (event.type) {
                     case SDL_EVENT_QUIT:
-                        std::cout << "🚪 Otrzymano event quit\n";
+                        log_info("🚪 Otrzymano event quit");
                         stop();
                         break;
                     case SDL_EVENT_KEY_DOWN:
                         if (event.key.key == SDLK_ESCAPE) {
-                            std::cout << "⎋ Escape naciśnięty\n";
+                            log_info("⎋ Escape naciśnięty");
                             stop();
+                        } else if (event.key.key == SDLK_F3 && !event.key.repeat) {
+                            m_hud.toggle();
+                        } else if (event.key.key == SDLK_F4 && !event.key.repeat) {
+                            verify_rollback();
                         }
                         break;
                     case SDL_EVENT_WINDOW_RESIZED:
@@ -183,12 +264,29 @@ namespace SDL_App {
                 return;
             }
 
-            performRender(m_sdl_state->renderer.get(), render_config.clear_color);
-            SDL_FRect src_rect{0, 0, m_sprite_size, m_sprite_size};
-            SDL_FRect dst_rect{m_player_x, m_floor - m_sprite_size, m_sprite_size, m_sprite_size};
-            //SDL_RenderTexture(m_sdl_state->renderer.get(), m_idle_texture.get(), &src_rect, &dst_rect);
-            SDL_RenderTextureRotated(m_sdl_state->renderer.get(), m_idle_texture.get(), &src_rect, &dst_rect, 0,
-                                     nullptr, (m_flip_horizontal) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+            {
+                ScopedPhaseTimer phase_timer(m_hud, FramePhase::Render);
+                performRender(m_sdl_state->renderer.get(), render_config.clear_color);
+                if (m_world_streamer) {
+                    // Tekstury regionów powstają tylko tutaj, na wątku renderującym
+                    m_world_streamer->pump_uploads(m_sdl_state->renderer.get());
+                    // Draw calls kafelków trafiają do HUD z samego streamera
+                    m_world_streamer->render(m_sdl_state->renderer.get(), m_camera);
+                }
+                SDL_FRect src_rect{0, 0, m_sprite_size, m_sprite_size};
+                SDL_FRect dst_rect{
+                    m_world.position_x[0] - m_camera.x, m_world.position_y[0] - m_camera.y, m_sprite_size, m_sprite_size
+                };
+                //SDL_RenderTexture(m_sdl_state->renderer.get(), m_idle_texture.get(), &src_rect, &dst_rect);
+                SDL_RenderTextureRotated(m_sdl_state->renderer.get(), m_idle_texture.get(), &src_rect, &dst_rect, 0,
+                                         nullptr, (m_world.flip_horizontal[0]) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+                m_hud.count_draw_call();
+            }
+
+            // HUD poza pomiarem fazy render, żeby nie zawyżał wyników
+            m_hud.draw(m_sdl_state->renderer.get());
+
+            ScopedPhaseTimer phase_timer(m_hud, FramePhase::Present);
             SDL_RenderPresent(m_sdl_state->renderer.get());
         }
 
@@ -197,19 +295,65 @@ namespace SDL_App {
         }
 
         void move_player(float delta_time) noexcept {
-            if (m_keys[SDL_SCANCODE_A]) {
-                m_move_amount += -5.0f;
-                m_flip_horizontal = true;
-            } else if (m_keys[SDL_SCANCODE_D]) {
-                m_move_amount += 5.0f;
-                m_flip_horizontal = false;
-            } else {
-                m_move_amount = 0.0f;
+            ScopedPhaseTimer phase_timer(m_hud, FramePhase::Update);
+            report_streaming();
+
+            // R przewija świat wstecz o klatkę na klatkę
+            if (m_keys[SDL_SCANCODE_R]) {
+                [[maybe_unused]] const bool rewound = m_snapshots.rewind(m_world);
+                follow_player();
+                return;
+            }
+
+            const FrameInput input{
+                .delta_time = delta_time,
+                .left = m_keys[SDL_SCANCODE_A],
+                .right = m_keys[SDL_SCANCODE_D],
+            };
+            step_world(m_world, input);
+            m_inputs[m_world.frame % m_inputs.size()] = input;
+            m_snapshots.save(m_world);
+            follow_player();
+        }
+
+        // Przywraca stan sprzed frames_back klatek i symuluje ponownie zapisane wejścia.
+        // Bez alokacji, koszt: restore + frames_back kroków symulacji.
+        [[nodiscard]] bool rollback(std::size_t frames_back) noexcept {
+            const auto target_frame = m_world.frame;
+            if (!m_snapshots.restore(frames_back, m_world)) {
+                return false;
+            }
+            while (m_world.frame < target_frame) {
+                step_world(m_world, m_inputs[(m_world.frame + 1) % m_inputs.size()]);
+            }
+            return true;
+        }
+
+        // Sprawdzenie determinizmu: rollback o rollback_frames klatek musi odtworzyć bieżący stan
+        void verify_rollback() noexcept {
+            const SimulationWorld expected = m_world;
+            const Uint64 start = SDL_GetPerformanceCounter();
+            if (!rollback(rollback_frames)) {
+                log_warn("⚠️  Rollback: za mało zapisanych klatek ({})", m_snapshots.size());
+                return;
+            }
+            const double elapsed_ms = static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0 /
+                                      static_cast<double>(SDL_GetPerformanceFrequency());
+            if (expected != m_world) {
+                log_error("❌ Rollback o {} klatek rozjechał się ze stanem bieżącym", rollback_frames);
+                m_world = expected;
+                return;
             }
-            m_player_x += m_move_amount * delta_time;
+            log_info("⏪ Rollback o {} klatek OK ({:.3f} ms)", rollback_frames, elapsed_ms);
         }
 
         void update_delta_time() noexcept {
+            // Początek nowej klatki - poprzednia trafia do historii HUD.
+            // Każda klatka po inicjalizacji zasobów jest steady-state, chyba że streaming
+            // dociąga regiony - tworzenie tekstur alokuje. Regiony wstrzymane przez limit pamięci
+            // nie są w pending_regions, więc nie wyłączają trybu ścisłego na stałe.
+            AllocationTracker::begin_frame(!m_world_streamer || m_world_streamer->stats().pending_regions == 0);
+            m_hud.begin_frame();
             Uint64 current_time = SDL_GetTicks();
             m_delta_time = (current_time - m_last_frame_time) / 1000.0f;
 
@@ -231,7 +375,13 @@ namespace SDL_App {
 int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
     using namespace std::chrono_literals;
 
-    std::cout << "🚀 Uruchamianie Modern C++ SDL3\n";
+    // Hooki pamięci SDL muszą być ustawione przed SDL_Init
+    AllocationTracker::install_sdl_hooks();
+
+    // Logger startuje pierwszy i zatrzymuje się ostatni - opróżnia kolejki po sprzątaniu SDL
+    LoggerGuard logger_guard(LoggerConfig{});
+
+    log_info("🚀 Uruchamianie Modern C++ SDL3");
 
     // Configuration
     WindowConfig window_config{
@@ -251,7 +401,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
     auto init_result = sdl_initializer.initialize(window_config, render_config);
     if (!init_result) [[unlikely]] {
         const auto error_msg = error_to_string(init_result.error());
-        std::cerr << std::format("❌ {}\n", error_msg);
+        log_error("❌ {}", error_msg);
         SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL Init Error",
                                  error_msg.c_str(), nullptr);
         return 1;
@@ -264,11 +414,27 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
     auto resources_result = game_loop.initialize_resources();
     if (!resources_result) [[unlikely]] {
         const auto error_msg = error_to_string(resources_result.error());
-        std::cerr << std::format("❌ {}\n", error_msg);
+        log_error("❌ {}", error_msg);
         return 1;
     }
 
-    std::cout << "🎮 Naciśnij ESC lub zamknij okno, aby zakończyć\n";
+    log_info("🎮 Naciśnij ESC lub zamknij okno, aby zakończyć");
+    log_info("📊 F3 przełącza HUD wydajności");
+    log_info("⏪ R przewija czas wstecz");
+    log_info("🔁 F4 sprawdza rollback o {} klatek", rollback_frames);
+
+    // --strict-allocations: raport alokacji w steady-state, --strict-allocations=abort: przerwanie programu
+    for (const std::string_view arg: std::span(argv, argc).subspan(1)) {
+        if (arg == "--strict-allocations" || arg == "--strict-allocations=abort") {
+            if constexpr (!AllocationTracker::enabled()) {
+                log_warn("⚠️  Zbudowano bez DRUGSWAR_TRACK_ALLOCATIONS - tryb ścisły nieaktywny");
+            }
+            constexpr std::uint64_t warmup_frames{120};
+            AllocationTracker::enable_strict_mode(warmup_frames, arg.ends_with("abort")
+                                                                     ? AllocationPolicy::Abort
+                                                                     : AllocationPolicy::Report);
+        }
+    }
 
     // Main game loop
     while (game_loop.is_running()) {
@@ -278,6 +444,6 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
         game_loop.move_player(game_loop.get_delta_time());
     }
 
-    std::cout << std::format("🎮 Gra zakończona.\n");
+    log_info("🎮 Gra zakończona.");
     return 0;
 }
@@ -0,0 +1,194 @@
+//
+// Created by mic on 19.10.26.
+//
+
+// Test bez okna: mikser przy pełnym limicie głosów, potem cały AudioSystem na sterowniku dummy.
+// Zwraca 0 gdy nie było underrunów, a szczytowe obciążenie miksera mieści się w budżecie.
+
+#include <SDL3/SDL.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../SDL_CPP/include/SDLArgumentsStructure.hpp"
+#include "../SDL_CPP/include/SDLAudio.hpp"
+#include "../SDL_CPP/include/SDLLogger.hpp"
+
+namespace {
+    // Budżet CPU miksera: 25% czasu trwania bloku
+    constexpr std::uint32_t mix_budget_permille{250};
+    constexpr std::size_t target_voices{32};
+    constexpr int frequency{48000};
+    constexpr int channels{2};
+    constexpr std::size_t mixer_blocks{2000};
+    constexpr std::size_t block_samples{1024};
+    constexpr auto device_run_time = std::chrono::seconds(2);
+
+    int g_failures{0};
+
+    void expect(bool condition, const char *what) {
+        if (!condition) {
+            log_error("❌ FAIL: {}", what);
+            ++g_failures;
+        }
+    }
+
+    SfxClip make_clip(float seconds, float pitch) {
+        SfxClip clip{};
+        const auto frames = static_cast<std::size_t>(seconds * frequency);
+        clip.samples.resize(frames * channels);
+        for (std::size_t frame = 0; frame < frames; ++frame) {
+            const float value = 0.1f * std::sin(static_cast<float>(frame) * pitch);
+            for (int channel = 0; channel < channels; ++channel) {
+                clip.samples[frame * channels + channel] = value;
+            }
+        }
+        return clip;
+    }
+
+    void put_le(std::ofstream &file, std::uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    // 24-bit stereo - ramka 6 B, porcje streamingu muszą być do niej wyrównane
+    bool write_test_wav(const std::filesystem::path &path, int sample_rate, int seconds) {
+        constexpr int wav_channels{2};
+        constexpr int bytes_per_sample{3};
+        const auto frames = static_cast<std::uint32_t>(sample_rate * seconds);
+        const std::uint32_t data_bytes = frames * wav_channels * bytes_per_sample;
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return false;
+        file.write("RIFF", 4);
+        put_le(file, 36 + data_bytes, 4);
+        file.write("WAVEfmt ", 8);
+        put_le(file, 16, 4);
+        put_le(file, 1, 2);
+        put_le(file, wav_channels, 2);
+        put_le(file, static_cast<std::uint32_t>(sample_rate), 4);
+        put_le(file, static_cast<std::uint32_t>(sample_rate * wav_channels * bytes_per_sample), 4);
+        put_le(file, wav_channels * bytes_per_sample, 2);
+        put_le(file, bytes_per_sample * 8, 2);
+        file.write("data", 4);
+        put_le(file, data_bytes, 4);
+        for (std::uint32_t frame = 0; frame < frames; ++frame) {
+            const auto value = static_cast<std::int32_t>(
+                400000.0 * std::sin(static_cast<double>(frame) * 0.05));
+            for (int channel = 0; channel < wav_channels; ++channel) {
+                put_le(file, static_cast<std::uint32_t>(value), bytes_per_sample);
+            }
+        }
+        return static_cast<bool>(file);
+    }
+
+    // Sam mikser: ring muzyki zasilany przed każdym blokiem, wszystkie głosy zajęte
+    void test_mixer_at_voice_limit() {
+        AudioMixer mixer(frequency, channels, target_voices);
+        const auto clip = make_clip(1.0f, 0.03f);
+        const auto music = make_clip(0.1f, 0.01f);
+
+        // Ponad limit - nadmiarowe polecenia kradną najstarsze głosy
+        constexpr std::size_t extra_voices{8};
+        for (std::size_t i = 0; i < target_voices + extra_voices; ++i) {
+            expect(mixer.play(clip, 0.5f), "play command queued");
+        }
+
+        mixer.set_music_active(true);
+        std::vector<float> block(block_samples);
+        std::size_t music_cursor = 0;
+        for (std::size_t i = 0; i < mixer_blocks; ++i) {
+            for (std::size_t written = 0; written < block.size();) {
+                const auto count = std::min(block.size() - written, music.samples.size() - music_cursor);
+                written += mixer.music().write(std::span(music.samples.data() + music_cursor, count));
+                music_cursor = (music_cursor + count) % music.samples.size();
+            }
+            mixer.mix(block);
+            // Głosy wygasają po 1 s - dokładamy, żeby limit był cały czas wypełniony
+            if (i % 32 == 0) {
+                for (std::size_t voice = 0; voice < target_voices; ++voice) {
+                    mixer.play(clip, 0.5f);
+                }
+            }
+        }
+
+        const auto stats = mixer.stats();
+        log_info("mixer: underruns {} stolen {} peak {}‰ voices {}",
+                 stats.underruns, stats.voices_stolen, stats.peak_mix_load_permille, stats.active_voices);
+        expect(stats.underruns == 0, "mixer: no underruns with a fed music ring");
+        expect(stats.voices_stolen >= extra_voices, "mixer: voices over the limit are stolen");
+        expect(stats.active_voices == target_voices, "mixer: voice limit stays saturated");
+        expect(stats.peak_mix_load_permille <= mix_budget_permille, "mixer: peak load within budget");
+    }
+
+    // Pełny system: urządzenie dummy, muzyka 24-bit streamowana z pliku, SFX przy limicie głosów
+    void test_audio_system_dummy_driver() {
+        if (!SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy") || !SDL_Init(SDL_INIT_AUDIO)) {
+            log_error("❌ SDL_Init(SDL_INIT_AUDIO) with dummy driver failed: {}", SDL_GetError());
+            ++g_failures;
+            return;
+        }
+
+        const auto wav_path = std::filesystem::temp_directory_path() / "drugswar_audio_test.wav";
+        expect(write_test_wav(wav_path, 44100, 1), "test wav written");
+
+        {
+            auto audio_result = createAudioSystem(AudioConfig{
+                .frequency = frequency, .channels = channels, .max_voices = target_voices, .master_gain = 0.8f
+            });
+            expect(audio_result.has_value(), "AudioSystem opened on dummy driver");
+            if (audio_result) {
+                auto &audio = *audio_result.value();
+                const auto clip = make_clip(0.25f, 0.02f);
+                audio.play_music(wav_path.string(), true);
+
+                // Rozbieg: pierwsze dane muzyki w ringu
+                const auto warmup_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                while (audio.stats().music_frames == 0 && std::chrono::steady_clock::now() < warmup_deadline) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+
+                const auto end = std::chrono::steady_clock::now() + device_run_time;
+                while (std::chrono::steady_clock::now() < end) {
+                    for (std::size_t voice = 0; voice < target_voices; ++voice) {
+                        audio.play_sfx(&clip, 0.3f);
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                }
+
+                const auto stats = audio.stats();
+                log_info("device: driver {} underruns {} music {} frames, mixed {} frames, peak {}‰",
+                         SDL_GetCurrentAudioDriver(), stats.underruns, stats.music_frames,
+                         stats.mixed_frames, stats.peak_mix_load_permille);
+                expect(stats.music_frames > 0, "device: streamed 24-bit music reaches the mixer");
+                expect(stats.underruns == 0, "device: no underruns at target voice count");
+                expect(stats.peak_mix_load_permille <= mix_budget_permille, "device: peak load within budget");
+            }
+        }
+
+        std::error_code error{};
+        std::filesystem::remove(wav_path, error);
+        SDL_Quit();
+    }
+} // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+    LoggerGuard logger_guard(LoggerConfig{});
+
+    test_mixer_at_voice_limit();
+    test_audio_system_dummy_driver();
+
+    if (g_failures == 0) {
+        log_info("✅ AudioMixerTest: OK");
+    }
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+//
+// Created by mic on 19.10.26.
+//
+
+// Test bez okna: WorldStreamer na wygenerowanej mapie .tmj z tilesetami PNG, renderer programowy.
+// Kamera przechodzi po ścieżce, a test sprawdza limit pamięci, histerezę load/unload_radius,
+// ponowne dekodowanie zwolnionych tilesetów i powrót pending_regions do zera.
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../SDL_CPP/include/SDLArgumentsStructure.hpp"
+#include "../SDL_CPP/include/SDLLogger.hpp"
+#include "../SDL_CPP/include/SDLResourcesAliases.hpp"
+#include "../SDL_CPP/include/SDLWorldStreaming.hpp"
+
+namespace {
+    constexpr int map_tiles{64};
+    constexpr int tile_size{16};
+    constexpr int region_tiles{8};
+    constexpr int regions_per_row{map_tiles / region_tiles};
+    constexpr float region_pixels{region_tiles * tile_size};
+    constexpr int tileset_pixels{64};
+    constexpr int tileset_tiles{(tileset_pixels / tile_size) * (tileset_pixels / tile_size)};
+    constexpr std::size_t tileset_bytes{tileset_pixels * tileset_pixels * 4};
+    constexpr std::array<SDL_Color, 3> tileset_colors{{{220, 40, 40, 255}, {40, 220, 40, 255}, {40, 40, 220, 255}}};
+    constexpr int view_w{320};
+    constexpr int view_h{240};
+    constexpr float walk_step{8.0f};
+    constexpr auto settle_timeout = std::chrono::seconds(5);
+
+    int g_failures{0};
+
+    void expect(bool condition, const char *what) {
+        if (!condition) {
+            log_error("❌ FAIL: {}", what);
+            ++g_failures;
+        }
+    }
+
+    // Kolumny regionów 0-2 -> tileset 0, 3-5 -> 1, 6-7 -> 2: przejście w poprzek mapy zwalnia tilesety
+    int tileset_for_column(int region_x) {
+        return std::min(region_x * static_cast<int>(tileset_colors.size()) / regions_per_row,
+                        static_cast<int>(tileset_colors.size()) - 1);
+    }
+
+    bool write_tileset(const std::filesystem::path &path, SDL_Color color) {
+        SDL_SurfacePtr surface{SDL_CreateSurface(tileset_pixels, tileset_pixels, SDL_PIXELFORMAT_RGBA32)};
+        if (!surface) return false;
+        SDL_FillSurfaceRect(surface.get(), nullptr, SDL_MapSurfaceRGBA(surface.get(), color.r, color.g, color.b, color.a));
+        return IMG_SavePNG(surface.get(), path.string().c_str());
+    }
+
+    // Mapa Tiled (JSON): jedna warstwa kafelków, jedna warstwa obiektów z obiektem w środku każdego regionu
+    bool write_map(const std::filesystem::path &path) {
+        std::ofstream file(path);
+        if (!file) return false;
+        file << R"({"type":"map","version":"1.10","tiledversion":"1.10.2","orientation":"orthogonal",)"
+             << R"("renderorder":"right-down","infinite":false,"nextlayerid":3,"nextobjectid":)"
+             << regions_per_row * regions_per_row + 1 << ','
+             << R"("width":)" << map_tiles << R"(,"height":)" << map_tiles
+             << R"(,"tilewidth":)" << tile_size << R"(,"tileheight":)" << tile_size << ',';
+
+        file << R"("layers":[{"id":1,"name":"ground","type":"tilelayer","x":0,"y":0,"opacity":1,"visible":true,)"
+             << R"("width":)" << map_tiles << R"(,"height":)" << map_tiles << R"(,"data":[)";
+        for (int y = 0; y < map_tiles; ++y) {
+            for (int x = 0; x < map_tiles; ++x) {
+                const int tileset = tileset_for_column(x / region_tiles);
+                file << (x + y == 0 ? "" : ",") << 1 + tileset * tileset_tiles + (x + y) % tileset_tiles;
+            }
+        }
+        file << R"(]},{"id":2,"name":"objects","type":"objectgroup","x":0,"y":0,"opacity":1,"visible":true,)"
+             << R"("draworder":"topdown","objects":[)";
+        for (int region = 0; region < regions_per_row * regions_per_row; ++region) {
+            const float x = (static_cast<float>(region % regions_per_row) + 0.5f) * region_pixels;
+            const float y = (static_cast<float>(region / regions_per_row) + 0.5f) * region_pixels;
+            file << (region == 0 ? "" : ",") << R"({"id":)" << region + 1 << R"(,"name":"marker","type":"",)"
+                 << R"("x":)" << x << R"(,"y":)" << y << R"(,"width":8,"height":8,"rotation":0,"visible":true})";
+        }
+        file << "]}],";
+
+        file << R"("tilesets":[)";
+        for (std::size_t t = 0; t < tileset_colors.size(); ++t) {
+            file << (t == 0 ? "" : ",") << R"({"firstgid":)" << 1 + static_cast<int>(t) * tileset_tiles
+                 << R"(,"name":"tileset)" << t << R"(","image":"tileset)" << t << R"(.png",)"
+                 << R"("imagewidth":)" << tileset_pixels << R"(,"imageheight":)" << tileset_pixels
+                 << R"(,"tilewidth":)" << tile_size << R"(,"tileheight":)" << tile_size
+                 << R"(,"tilecount":)" << tileset_tiles << R"(,"columns":)" << tileset_pixels / tile_size
+                 << R"(,"margin":0,"spacing":0})";
+        }
+        file << "]}";
+        return static_cast<bool>(file);
+    }
+
+    // Ta sama miara co WorldStreamer: odległość kamery od najbliższego punktu regionu
+    float distance_to(RegionCoord coord, float x, float y) {
+        const float left = static_cast<float>(coord.x) * region_pixels;
+        const float top = static_cast<float>(coord.y) * region_pixels;
+        const float dx = std::max({left - x, 0.0f, x - (left + region_pixels)});
+        const float dy = std::max({top - y, 0.0f, y - (top + region_pixels)});
+        return std::hypot(dx, dy);
+    }
+
+    bool is_resident(const std::vector<RegionStats> &regions, RegionCoord coord) {
+        return std::ranges::any_of(regions, [coord](const auto &region) { return region.coord == coord; });
+    }
+
+    // Klatka gry: update + upload + render, po każdej sprawdzenie limitu i histerezy
+    class StreamingDriver {
+    private:
+        WorldStreamer &m_streamer;
+        SDL_Renderer *m_renderer;
+        StreamingConfig m_config;
+        bool m_check_hysteresis;
+        std::vector<RegionStats> m_resident{};
+        std::vector<RegionStats> m_previous{};
+        std::uint32_t m_last_draws{0};
+
+    public:
+        StreamingDriver(WorldStreamer &streamer, SDL_Renderer *renderer, const StreamingConfig &config,
+                        bool check_hysteresis)
+            : m_streamer(streamer), m_renderer(renderer), m_config(config), m_check_hysteresis(check_hysteresis) {
+        }
+
+        void frame(float x, float y) {
+            m_streamer.update(x, y);
+            m_streamer.pump_uploads(m_renderer);
+            SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+            SDL_RenderClear(m_renderer);
+            const SDL_FRect view{x - view_w * 0.5f, y - view_h * 0.5f, view_w, view_h};
+            m_last_draws = m_streamer.render(m_renderer, view);
+
+            const auto &stats = m_streamer.stats();
+            expect(stats.region_bytes + stats.texture_bytes + stats.surface_bytes <= m_config.memory_cap_bytes,
+                   "streaming memory stays within memory_cap_bytes");
+
+            std::swap(m_previous, m_resident);
+            m_streamer.collect_region_stats(m_resident);
+            if (!m_check_hysteresis) return;
+            for (const auto &region: m_previous) {
+                if (!is_resident(m_resident, region.coord)) {
+                    expect(distance_to(region.coord, x, y) > m_config.unload_radius,
+                           "regions inside unload_radius are not evicted");
+                }
+            }
+        }
+
+        // Kamera stoi, aż wątek roboczy i uploady skończą
+        bool settle(float x, float y) {
+            const auto deadline = std::chrono::steady_clock::now() + settle_timeout;
+            do {
+                frame(x, y);
+                if (m_streamer.stats().pending_regions == 0) return true;
+                SDL_Delay(1);
+            } while (std::chrono::steady_clock::now() < deadline);
+            return false;
+        }
+
+        void walk(float from_x, float to_x, float y) {
+            const float direction = to_x > from_x ? walk_step : -walk_step;
+            for (float x = from_x; std::abs(to_x - x) >= walk_step; x += direction) {
+                frame(x, y);
+            }
+            frame(to_x, y);
+        }
+
+        [[nodiscard]] const std::vector<RegionStats> &resident() const noexcept {
+            return m_resident;
+        }
+
+        [[nodiscard]] std::uint32_t last_draws() const noexcept {
+            return m_last_draws;
+        }
+    };
+
+    bool pixel_matches(SDL_Renderer *renderer, int x, int y, SDL_Color color) {
+        SDL_SurfacePtr pixels{SDL_RenderReadPixels(renderer, nullptr)};
+        if (!pixels) return false;
+        Uint8 r{}, g{}, b{}, a{};
+        if (!SDL_ReadSurfacePixel(pixels.get(), x, y, &r, &g, &b, &a)) return false;
+        return r == color.r && g == color.g && b == color.b;
+    }
+
+    // Duży limit: histereza, zwolnienie tilesetu 0 po przejściu na drugi koniec mapy i ponowne dekodowanie
+    void test_camera_path(const std::filesystem::path &map_path, SDL_Renderer *renderer) {
+        const StreamingConfig config{
+            .region_tiles = region_tiles, .load_radius = 160.0f, .unload_radius = 320.0f,
+            .memory_cap_bytes = 16u * 1024u * 1024u, .max_uploads_per_frame = 2
+        };
+        auto streamer_result = createWorldStreamer(map_path.string(), config, nullptr);
+        expect(streamer_result.has_value(), "streamer created from generated map");
+        if (!streamer_result) return;
+        auto &streamer = *streamer_result.value();
+        StreamingDriver driver(streamer, renderer, config, true);
+
+        expect(driver.settle(200.0f, 64.0f), "pending_regions returns to 0 at start");
+        expect(is_resident(driver.resident(), {2, 0}), "region (2, 0) loaded inside load_radius");
+        std::size_t entities = 0;
+        streamer.for_each_resident_entity([&entities](const RegionEntity &) { ++entities; });
+        expect(entities == streamer.stats().resident_regions, "one marker entity per resident region");
+
+        // Region (2, 0) jest 236 px od kamery w x=20: między load_radius a unload_radius
+        expect(driver.settle(20.0f, 64.0f), "pending_regions returns to 0 after a short move");
+        expect(is_resident(driver.resident(), {2, 0}), "hysteresis keeps region (2, 0) resident");
+
+        // Na drugi koniec mapy: regiony tilesetu 0 poza unload_radius, jego tekstura zwolniona
+        driver.walk(20.0f, 960.0f, 64.0f);
+        expect(driver.settle(960.0f, 64.0f), "pending_regions returns to 0 at the far end");
+        expect(!is_resident(driver.resident(), {0, 0}), "region (0, 0) evicted beyond unload_radius");
+        expect(streamer.stats().texture_bytes <= 2 * tileset_bytes, "tileset 0 texture released");
+        expect(streamer.stats().evictions > 0, "camera path evicts regions");
+
+        // Powrót: tileset 0 musi zostać zdekodowany ponownie i narysowany
+        driver.walk(960.0f, 64.0f, 64.0f);
+        expect(driver.settle(64.0f, 64.0f), "pending_regions returns to 0 after returning");
+        expect(is_resident(driver.resident(), {0, 0}), "region (0, 0) resident again");
+        expect(driver.last_draws() > 0, "resident tiles are drawn");
+        expect(pixel_matches(renderer, view_w / 2, view_h / 2, tileset_colors[0]),
+               "re-decoded tileset 0 is on screen");
+        expect(streamer.stats().deferred_by_cap == 0, "large cap never defers");
+
+        const auto &stats = streamer.stats();
+        log_info("path: resident {} evictions {} region {} B texture {} B max latency {:.2f} ms",
+                 stats.resident_regions, stats.evictions, stats.region_bytes, stats.texture_bytes,
+                 stats.max_load_latency_ms);
+    }
+
+    // Limit na jeden tileset: na granicy tilesetów 0 i 1 część regionów czeka, ale nie blokuje pending_regions
+    void test_memory_cap(const std::filesystem::path &map_path, SDL_Renderer *renderer) {
+        const StreamingConfig config{
+            .region_tiles = region_tiles, .load_radius = 160.0f, .unload_radius = 320.0f,
+            .memory_cap_bytes = tileset_bytes + 8u * 1024u, .max_uploads_per_frame = 2
+        };
+        auto streamer_result = createWorldStreamer(map_path.string(), config, nullptr);
+        expect(streamer_result.has_value(), "capped streamer created");
+        if (!streamer_result) return;
+        auto &streamer = *streamer_result.value();
+        // Ewikcje z limitu są dozwolone między promieniami - histereza sprawdzana w test_camera_path
+        StreamingDriver driver(streamer, renderer, config, false);
+
+        expect(driver.settle(384.0f, 64.0f), "pending_regions returns to 0 with regions deferred by the cap");
+        expect(streamer.stats().deferred_regions > 0, "regions over the cap are deferred");
+        expect(streamer.stats().deferred_by_cap > 0, "deferral counted");
+        const auto deferred_by_cap = streamer.stats().deferred_by_cap;
+        for (int i = 0; i < 60; ++i) {
+            driver.frame(384.0f, 64.0f);
+        }
+        expect(streamer.stats().deferred_by_cap == deferred_by_cap, "waiting regions are counted once per load");
+
+        // Dalej od granicy wszystko, czego potrzeba, mieści się w limicie
+        driver.walk(384.0f, 960.0f, 64.0f);
+        expect(driver.settle(960.0f, 64.0f), "pending_regions returns to 0 after leaving the border");
+        expect(streamer.stats().deferred_regions == 0, "deferred regions released after moving away");
+        expect(is_resident(driver.resident(), {7, 0}), "region (7, 0) resident under the cap");
+        expect(pixel_matches(renderer, view_w / 2, view_h / 2, tileset_colors[2]), "tileset 2 is on screen");
+
+        const auto &stats = streamer.stats();
+        log_info("cap: resident {} deferred {} evictions {} used {} / {} B",
+                 stats.resident_regions, stats.deferred_by_cap, stats.evictions,
+                 stats.region_bytes + stats.texture_bytes + stats.surface_bytes, config.memory_cap_bytes);
+    }
+} // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+    LoggerGuard logger_guard(LoggerConfig{});
+
+    if (!SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy") || !SDL_Init(SDL_INIT_VIDEO)) {
+        log_error("❌ SDL_Init(SDL_INIT_VIDEO) with dummy driver failed: {}", SDL_GetError());
+        return 1;
+    }
+
+    const auto directory = std::filesystem::temp_directory_path() / "drugswar_streaming_test";
+    std::error_code error{};
+    std::filesystem::create_directories(directory, error);
+    const auto map_path = directory / "world.tmj";
+    bool files_ok = write_map(map_path);
+    for (std::size_t t = 0; t < tileset_colors.size(); ++t) {
+        files_ok = write_tileset(directory / ("tileset" + std::to_string(t) + ".png"), tileset_colors[t]) && files_ok;
+    }
+    expect(files_ok, "test map and tilesets written");
+
+    {
+        SDL_SurfacePtr target{SDL_CreateSurface(view_w, view_h, SDL_PIXELFORMAT_RGBA32)};
+        SDL_RendererPtr renderer{target ? SDL_CreateSoftwareRenderer(target.get()) : nullptr};
+        expect(renderer != nullptr, "software renderer created");
+        if (files_ok && renderer) {
+            test_camera_path(map_path, renderer.get());
+            test_memory_cap(map_path, renderer.get());
+        }
+    }
+
+    std::filesystem::remove_all(directory, error);
+    SDL_Quit();
+
+    if (g_failures == 0) {
+        log_info("✅ WorldStreamingTest: OK");
+    }
+    return g_failures == 0 ? 0 : 1;
+}